@@ -0,0 +1,864 @@
+/*
+  ==============================================================================
+
+    Medidas de desempenho dos motores de filtro e do convolvedor.
+
+    Não faz parte do plugin: compile como um aplicativo de console JUCE, em modo
+    Release, com os módulos juce_core, juce_audio_basics e juce_dsp e a pasta
+    Source no caminho de includes. Sem argumentos roda todas as seções; com
+    nomes de seções, só elas:
+
+        FilterBenchmarks cascade grid
+
+    Cada medida é a mais rápida de numRuns rodadas, depois de uma rodada de
+    aquecimento, em nanossegundos por amostra de cada canal. A entrada é ruído
+    copiado para o buffer antes de cada bloco, e a cópia entra na medida.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BiquadCascade.h"
+#include "LinearPhaseConvolver.h"
+#include "ParallelCascade.h"
+#include "SvfCascade.h"
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace
+{
+    constexpr int numRuns = 5;
+
+    // Amostras de cada canal por rodada
+    constexpr int samplesPerRun = 1 << 20;
+
+    // Nanossegundos por amostra de cada canal de 'process', que processa um bloco
+    // de blockSize amostras de numChannels canais por chamada
+    template<typename Function>
+    double measure(int blockSize, int numChannels, Function&& process)
+    {
+        const auto numBlocks = (samplesPerRun + blockSize - 1) / blockSize;
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run <= numRuns; ++run)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int block = 0; block < numBlocks; ++block)
+                process();
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            // A rodada 0 só aquece caches e preditores
+            if (run > 0)
+                best = juce::jmin(best, seconds);
+        }
+
+        return best * 1.0e9 / ((double)numBlocks * blockSize * numChannels);
+    }
+
+    // Ruído uniforme em [-1, 1), sempre o mesmo
+    template<typename SampleType>
+    juce::AudioBuffer<SampleType> makeNoise(int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<SampleType> noise(numChannels, numSamples);
+        juce::Random random(1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = noise.getWritePointer(channel);
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = (SampleType)(random.nextFloat() * 2.f - 1.f);
+        }
+
+        return noise;
+    }
+
+    template<typename SampleType>
+    void copyInput(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& noise, int numSamples)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            std::memcpy(buffer.getWritePointer(channel), noise.getReadPointer(channel, 0), sizeof(SampleType) * (size_t)numSamples);
+    }
+
+    // LowCut e HighCut Butterworth de ordem cutOrder (sem eles com zero) e numPeaks
+    // bandas peak espalhadas de lowestPeak a 12 kHz, alternando +6 e -6 dB
+    ChainCoefficients makeChain(double sampleRate, int cutOrder, int numPeaks, DesignMethod method = Design_Bilinear, double lowestPeak = 100.0)
+    {
+        ChainCoefficients chain;
+
+        if (cutOrder > 0)
+        {
+            chain.lowCut = makeCutFilterHighPass(sampleRate, 40.0, cutOrder, Family_Butterworth, method);
+            chain.highCut = makeCutFilterLowPass(sampleRate, 16000.0, cutOrder, Family_Butterworth, method);
+        }
+
+        for (int band = 0; band < numPeaks; ++band)
+        {
+            const auto frequency = lowestPeak * std::pow(12000.0 / lowestPeak, (double)band / maxPeakBands);
+            chain.peaks.bands[(size_t)band] = makePeakCoefficients(sampleRate, frequency, 1.0, band % 2 == 0 ? 2.0 : 0.5, method);
+            chain.peaks.active[(size_t)band] = true;
+        }
+
+        return chain;
+    }
+
+    // A mesma cadeia para o motor SVF
+    SvfChainCoefficients makeSvfChain(const ChainCoefficients& chain)
+    {
+        SvfChainCoefficients svfChain;
+        svfChain.lowCut = makeSvfCutCoefficients(chain.lowCut);
+        svfChain.highCut = makeSvfCutCoefficients(chain.highCut);
+
+        for (int band = 0; band < maxPeakBands; ++band)
+        {
+            svfChain.peaks.bands[(size_t)band] = makeSvfCoefficients(chain.peaks.bands[(size_t)band]);
+            svfChain.peaks.active[(size_t)band] = chain.peaks.active[(size_t)band];
+        }
+
+        return svfChain;
+    }
+
+    //==============================================================================
+    // A cascata fundida contra a cadeia original, um ProcessorChain de
+    // juce::dsp::IIR::Filter por canal, em que cada filtro percorre o bloco todo
+    void benchmarkCascade()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int maxBlockSize = 4096;
+
+        using Filter = juce::dsp::IIR::Filter<float>;
+        using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+        using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+
+        // LowCut e HighCut de 48 dB/oct e um peak: as 9 seções da cadeia original
+        const auto chain = makeChain(sampleRate, 8, 1);
+
+        auto toFilter = [](const BiquadCoefficients& c)
+            {
+                return new juce::dsp::IIR::Coefficients<float>((float)c.b0, (float)c.b1, (float)c.b2, 1.f, (float)c.a1, (float)c.a2);
+            };
+
+        auto setCut = [&toFilter](CutFilter& cut, const CutFilterCoefficients& c)
+            {
+                cut.get<0>().coefficients = toFilter(c.sections[0]);
+                cut.get<1>().coefficients = toFilter(c.sections[1]);
+                cut.get<2>().coefficients = toFilter(c.sections[2]);
+                cut.get<3>().coefficients = toFilter(c.sections[3]);
+            };
+
+        MonoChain leftChain, rightChain;
+        const juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)maxBlockSize, 1 };
+
+        for (auto* monoChain : { &leftChain, &rightChain })
+        {
+            monoChain->prepare(spec);
+            setCut(monoChain->get<0>(), chain.lowCut);
+            monoChain->get<1>().coefficients = toFilter(chain.peaks.bands[0]);
+            setCut(monoChain->get<2>(), chain.highCut);
+        }
+
+        MultichannelCascade<float> cascade;
+        cascade.prepare(2, maxBlockSize);
+        cascade.setCoefficients(chain);
+
+        const auto noise = makeNoise<float>(2, maxBlockSize);
+        juce::AudioBuffer<float> buffer(2, maxBlockSize);
+
+        std::printf("cascade: 9 sections (48 dB/oct LowCut and HighCut, one peak), stereo float, ns per sample per channel\n");
+        std::printf("  block  ProcessorChain    fused  speedup\n");
+
+        for (int blockSize = 32; blockSize <= maxBlockSize; blockSize *= 2)
+        {
+            const auto original = measure(blockSize, 2, [&]
+                {
+                    copyInput(buffer, noise, blockSize);
+
+                    juce::dsp::AudioBlock<float> block(buffer);
+                    auto leftBlock = block.getSubBlock(0, (size_t)blockSize).getSingleChannelBlock(0);
+                    auto rightBlock = block.getSubBlock(0, (size_t)blockSize).getSingleChannelBlock(1);
+
+                    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+                    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+                    leftChain.process(leftContext);
+                    rightChain.process(rightContext);
+                });
+
+            const auto fused = measure(blockSize, 2, [&]
+                {
+                    copyInput(buffer, noise, blockSize);
+                    cascade.process(buffer, 0, blockSize);
+                });
+
+            std::printf("  %5d  %14.2f  %7.2f  %6.2fx\n", blockSize, original, fused, original / fused);
+        }
+
+        std::printf("\n");
+    }
+
+    //==============================================================================
+    // Custo da grade de coeficientes: a cada interval amostras a cadeia é
+    // recalculada e entregue à cascata, como no processBlock com um parâmetro
+    // automatizado. "full" reprojeta a cadeia inteira; "one peak", só uma banda.
+    void benchmarkGrid()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        constexpr int numPeaks = 8;
+
+        auto chain = makeChain(sampleRate, 8, numPeaks);
+
+        MultichannelCascade<float> cascade;
+        cascade.prepare(2, blockSize);
+        cascade.setCoefficients(chain);
+
+        const auto noise = makeNoise<float>(2, blockSize);
+        juce::AudioBuffer<float> buffer(2, blockSize);
+
+        // A frequência da banda automatizada varre 1 kHz ± 10% e nunca repete o projeto
+        int update = 0;
+        auto nextFrequency = [&update]
+            {
+                return 1000.0 * (1.0 + 0.1 * std::sin(0.01 * (double)++update));
+            };
+
+        std::printf("grid: 16 sections (48 dB/oct cuts, %d peaks), stereo float, block %d, ns per sample per channel\n", numPeaks, blockSize);
+        std::printf("  interval   static     full  one peak\n");
+
+        for (int interval = 8; interval <= 256; interval *= 2)
+        {
+            // Sem atualizações, medido de novo a cada linha para acompanhar o ruído da máquina
+            const auto still = measure(blockSize, 2, [&]
+                {
+                    copyInput(buffer, noise, blockSize);
+                    cascade.process(buffer, 0, blockSize);
+                });
+
+            const auto full = measure(blockSize, 2, [&]
+                {
+                    copyInput(buffer, noise, blockSize);
+
+                    for (int start = 0; start < blockSize; start += interval)
+                    {
+                        auto settings = makeChain(sampleRate, 8, numPeaks);
+                        settings.peaks.bands[0] = makePeakCoefficients(sampleRate, nextFrequency(), 1.0, 2.0, Design_Bilinear);
+
+                        cascade.setCoefficients(settings, interval);
+                        cascade.process(buffer, start, interval);
+                    }
+                });
+
+            const auto onePeak = measure(blockSize, 2, [&]
+                {
+                    copyInput(buffer, noise, blockSize);
+
+                    for (int start = 0; start < blockSize; start += interval)
+                    {
+                        chain.peaks.bands[0] = makePeakCoefficients(sampleRate, nextFrequency(), 1.0, 2.0, Design_Bilinear);
+
+                        cascade.setCoefficients(chain, interval);
+                        cascade.process(buffer, start, interval);
+                    }
+                });
+
+            std::printf("  %8d  %7.2f  %7.2f  %8.2f\n", interval, still, full, onePeak);
+        }
+
+        std::printf("\n");
+    }
+
+    //==============================================================================
+    // O caminho em double contra o em float. "converted" é o que o host pagaria
+    // sem processDoubleBlock nativo: converter o buffer double para float, filtrar
+    // em float e converter de volta. Em float as seções de polos muito próximos de
+    // z = 1 (o LowCut de 40 Hz, os peaks mais graves) rodam na forma SVF robusta,
+    // uma faixa por vez; em double a forma direta basta.
+    void benchmarkPrecision()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        const auto floatNoise = makeNoise<float>(2, blockSize);
+        const auto doubleNoise = makeNoise<double>(2, blockSize);
+        juce::AudioBuffer<float> floatBuffer(2, blockSize);
+        juce::AudioBuffer<double> doubleBuffer(2, blockSize);
+
+        std::printf("precision: stereo, block %d, ns per sample per channel\n", blockSize);
+        std::printf("  sections    float   double  converted\n");
+
+        for (const auto numPeaks : { 1, 9 })
+        {
+            const auto chain = makeChain(sampleRate, 8, numPeaks);
+
+            MultichannelCascade<float> floatCascade;
+            floatCascade.prepare(2, blockSize);
+            floatCascade.setCoefficients(chain);
+
+            MultichannelCascade<double> doubleCascade;
+            doubleCascade.prepare(2, blockSize);
+            doubleCascade.setCoefficients(chain);
+
+            const auto floatTime = measure(blockSize, 2, [&]
+                {
+                    copyInput(floatBuffer, floatNoise, blockSize);
+                    floatCascade.process(floatBuffer, 0, blockSize);
+                });
+
+            const auto doubleTime = measure(blockSize, 2, [&]
+                {
+                    copyInput(doubleBuffer, doubleNoise, blockSize);
+                    doubleCascade.process(doubleBuffer, 0, blockSize);
+                });
+
+            const auto convertedTime = measure(blockSize, 2, [&]
+                {
+                    copyInput(doubleBuffer, doubleNoise, blockSize);
+
+                    for (int channel = 0; channel < 2; ++channel)
+                    {
+                        const auto* source = doubleBuffer.getReadPointer(channel, 0);
+                        auto* destination = floatBuffer.getWritePointer(channel);
+                        for (int i = 0; i < blockSize; ++i)
+                            destination[i] = (float)source[i];
+                    }
+
+                    floatCascade.process(floatBuffer, 0, blockSize);
+
+                    for (int channel = 0; channel < 2; ++channel)
+                    {
+                        const auto* source = floatBuffer.getReadPointer(channel, 0);
+                        auto* destination = doubleBuffer.getWritePointer(channel);
+                        for (int i = 0; i < blockSize; ++i)
+                            destination[i] = (double)source[i];
+                    }
+                });
+
+            std::printf("  %8d  %7.2f  %7.2f  %9.2f\n", 8 + numPeaks, floatTime, doubleTime, convertedTime);
+        }
+
+        std::printf("\n");
+    }
+
+    //==============================================================================
+    // As duas etapas do convolvedor de fase linear, com as partições de
+    // PartitionedConvolver: a cabeça roda na thread de áudio a cada 64 amostras,
+    // a cauda na thread de trabalho a cada 1024. O uso de CPU é o de uma
+    // entrada estéreo a 48 kHz em cada thread.
+    void benchmarkConvolver()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int numChannels = 2;
+        constexpr auto headSize = PartitionedConvolver::headPartitionSize;
+        constexpr auto tailSize = PartitionedConvolver::tailPartitionSize;
+        constexpr auto tailOffset = PartitionedConvolver::tailOffset;
+
+        const auto noise = makeNoise<float>(numChannels, tailSize);
+        std::vector<float> output((size_t)tailSize);
+
+        auto toPercent = [](double nanoseconds) { return nanoseconds * sampleRate * numChannels * 1.0e-7; };
+
+        std::printf("convolver: stereo, ns per sample per channel, CPU %% of one core at 48 kHz\n");
+        std::printf("  length  head ns  head %%  tail ns  tail %%\n");
+
+        for (int length = 1024; length <= 16384; length *= 2)
+        {
+            std::vector<float> impulse;
+            makeLinearPhaseImpulse(makeChain(sampleRate, 8, 9), sampleRate, length, impulse);
+
+            const auto headLength = juce::jmin(length, tailOffset);
+            const auto tailLength = length - headLength;
+
+            ConvolutionStage head, tail;
+            head.prepare(headSize, tailOffset / headSize, numChannels);
+            head.setKernel(0, impulse.data(), headLength);
+            tail.prepare(tailSize, (tailLength + tailSize - 1) / tailSize, numChannels);
+            tail.setKernel(0, impulse.data() + headLength, tailLength);
+
+            const auto headTime = measure(headSize, numChannels, [&]
+                {
+                    for (size_t channel = 0; channel < numChannels; ++channel)
+                        head.process(channel, noise.getReadPointer((int)channel, 0), output.data(), 0, -1);
+
+                    head.advance();
+                });
+
+            if (tailLength == 0)
+            {
+                std::printf("  %6d  %7.2f  %5.1f%%        -       -\n", length, headTime, toPercent(headTime));
+                continue;
+            }
+
+            const auto tailTime = measure(tailSize, numChannels, [&]
+                {
+                    for (size_t channel = 0; channel < numChannels; ++channel)
+                        tail.process(channel, noise.getReadPointer((int)channel, 0), output.data(), 0, -1);
+
+                    tail.advance();
+                });
+
+            std::printf("  %6d  %7.2f  %5.1f%%  %7.2f  %5.1f%%\n", length, headTime, toPercent(headTime), tailTime, toPercent(tailTime));
+        }
+
+        std::printf("\n");
+    }
+
+    //==============================================================================
+    // A cadeia sobreamostrada, por amostra do host: "chain" é só a cascata na taxa
+    // multiplicada; "total" inclui a subida e a descida do juce::dsp::Oversampling,
+    // com os mesmos filtros de meia banda de prepareOversamplers().
+    void benchmarkOversampling()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        constexpr int numChannels = 2;
+
+        using Oversampling = juce::dsp::Oversampling<float>;
+
+        const auto noise = makeNoise<float>(numChannels, blockSize * 8);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize * 8);
+
+        std::printf("oversampling: 17 sections, stereo float, host block %d, ns per host sample per channel\n", blockSize);
+        std::printf("  factor  filter    chain    total\n");
+
+        for (int order = 0; order <= 3; ++order)
+        {
+            const auto factor = 1 << order;
+            const auto numSamples = blockSize * factor;
+
+            MultichannelCascade<float> cascade;
+            cascade.prepare(numChannels, (size_t)numSamples);
+            cascade.setCoefficients(makeChain(sampleRate * factor, 8, 9));
+
+            const auto chainTime = measure(blockSize, numChannels, [&]
+                {
+                    copyInput(buffer, noise, numSamples);
+                    cascade.process(buffer, 0, numSamples);
+                });
+
+            if (order == 0)
+            {
+                std::printf("  %6d  %6s  %7.2f  %7.2f\n", factor, "-", chainTime, chainTime);
+                continue;
+            }
+
+            for (const auto filterType : { Oversampling::filterHalfBandPolyphaseIIR, Oversampling::filterHalfBandFIREquiripple })
+            {
+                Oversampling oversampler((size_t)numChannels, (size_t)order, filterType, true, true);
+                oversampler.initProcessing((size_t)blockSize);
+
+                const auto totalTime = measure(blockSize, numChannels, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+
+                        juce::dsp::AudioBlock<float> block(buffer);
+                        auto hostBlock = block.getSubBlock(0, (size_t)blockSize);
+
+                        cascade.process(oversampler.processSamplesUp(hostBlock));
+                        oversampler.processSamplesDown(hostBlock);
+                    });
+
+                std::printf("  %6d  %6s  %7.2f  %7.2f\n", factor,
+                            filterType == Oversampling::filterHalfBandPolyphaseIIR ? "IIR" : "FIR", chainTime, totalTime);
+            }
+        }
+
+        std::printf("\n");
+    }
+
+    //==============================================================================
+    // Projeto casado contra o bilinear: o maior erro em dB em relação ao filtro
+    // analógico de 20 Hz a 20 kHz, a 44,1 kHz, e o custo do casado em 1x contra o
+    // do bilinear com sobreamostragem de 4x, a outra forma de evitar a compressão
+    // de frequência perto de Nyquist. Nos cortes só conta a faixa acima de -60 dB.
+    void benchmarkMatched()
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+        constexpr int numChannels = 2;
+        constexpr int numPoints = 2000;
+
+        // Máximo de |digital - analógico| em dB numa grade logarítmica de frequências
+        auto getMaximumError = [](auto&& digitalMagnitude, auto&& analogMagnitude)
+            {
+                auto maximumError = 0.0;
+
+                for (int i = 0; i < numPoints; ++i)
+                {
+                    const auto frequency = 20.0 * std::pow(1000.0, (double)i / (numPoints - 1));
+                    const auto target = juce::Decibels::gainToDecibels(analogMagnitude(frequency), -200.0);
+
+                    if (target > -60.0)
+                        maximumError = juce::jmax(maximumError, std::abs(juce::Decibels::gainToDecibels(digitalMagnitude(frequency), -200.0) - target));
+                }
+
+                return maximumError;
+            };
+
+        std::printf("matched: max dB error against the analog filter, 20 Hz to 20 kHz at 44.1 kHz\n");
+        std::printf("  filter                       bilinear  matched  bilinear 4x\n");
+
+        for (const auto frequency : { 1000.0, 5000.0, 10000.0, 15000.0 })
+        {
+            constexpr double quality = 2.0, gainFactor = 4.0;
+            const auto A = std::sqrt(gainFactor);
+
+            // (s^2 + s A / Q + 1) / (s^2 + s / (A Q) + 1) em s = j f / frequency
+            auto analog = [&](double f)
+                {
+                    const auto w = f / frequency;
+                    const auto real = 1.0 - w * w;
+                    return std::sqrt((real * real + w * w * A * A / (quality * quality))
+                                     / (real * real + w * w / (A * A * quality * quality)));
+                };
+
+            auto error = [&](double designRate, DesignMethod method)
+                {
+                    const auto section = makePeakCoefficients(designRate, frequency, quality, gainFactor, method);
+                    return getMaximumError([&](double f) { return section.getMagnitudeForFrequency(f, designRate); }, analog);
+                };
+
+            std::printf("  peak %5.0f Hz, +12 dB, Q 2   %8.3f  %7.3f  %11.3f\n", frequency,
+                        error(sampleRate, Design_Bilinear), error(sampleRate, Design_Matched), error(sampleRate * 4.0, Design_Bilinear));
+        }
+
+        for (const auto frequency : { 10000.0, 16000.0 })
+        {
+            constexpr int order = 8;
+
+            auto analog = [&](double f) { return 1.0 / std::sqrt(1.0 + std::pow(f / frequency, 2.0 * order)); };
+
+            auto error = [&](double designRate, DesignMethod method)
+                {
+                    const auto cut = makeCutFilterLowPass(designRate, frequency, order, Family_Butterworth, method);
+                    return getMaximumError([&](double f)
+                        {
+                            auto magnitude = 1.0;
+                            for (int i = 0; i < cut.numSections; ++i)
+                                magnitude *= cut.sections[(size_t)i].getMagnitudeForFrequency(f, designRate);
+                            return magnitude;
+                        }, analog);
+                };
+
+            std::printf("  HighCut %5.0f Hz, 48 dB/oct  %8.3f  %7.3f  %11.3f\n", frequency,
+                        error(sampleRate, Design_Bilinear), error(sampleRate, Design_Matched), error(sampleRate * 4.0, Design_Bilinear));
+        }
+
+        // O mesmo número de seções nos dois casos; o bilinear processa 4 vezes mais amostras
+        const auto noise = makeNoise<float>(numChannels, blockSize * 4);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize * 4);
+
+        MultichannelCascade<float> matched, oversampled;
+        matched.prepare(numChannels, blockSize);
+        matched.setCoefficients(makeChain(sampleRate, 8, 9, Design_Matched));
+        oversampled.prepare(numChannels, blockSize * 4);
+        oversampled.setCoefficients(makeChain(sampleRate * 4.0, 8, 9, Design_Bilinear));
+
+        const auto matchedTime = measure(blockSize, numChannels, [&]
+            {
+                copyInput(buffer, noise, blockSize);
+                matched.process(buffer, 0, blockSize);
+            });
+
+        const auto oversampledTime = measure(blockSize, numChannels, [&]
+            {
+                copyInput(buffer, noise, blockSize * 4);
+                oversampled.process(buffer, 0, blockSize * 4);
+            });
+
+        std::printf("  17 sections, stereo float, ns per host sample per channel: matched %.2f, bilinear 4x %.2f (chain only)\n",
+                    matchedTime, oversampledTime);
+
+        std::printf("\n");
+    }
+
+    //==============================================================================
+    // Os motores de filtro com a mesma cadeia: só bandas peak, até 12 kHz, a partir
+    // de 100 Hz ou de 1 kHz. Em float a forma paralela recusa os peaks mais graves,
+    // próximos demais de z = 1, e roda como a cascata.
+    template<typename SampleType>
+    void benchmarkEnginesFor(const char* typeName)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        std::printf("engines: peak bands only, %s, block %d, ns per sample per channel\n", typeName, blockSize);
+        std::printf("   lowest  channels  sections  cascade      SVF  parallel\n");
+
+        for (const auto numChannels : { 1, 2 })
+        {
+            const auto noise = makeNoise<SampleType>(numChannels, blockSize);
+            juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+
+            auto time = [&](auto& engine)
+                {
+                    return measure(blockSize, numChannels, [&]
+                        {
+                            copyInput(buffer, noise, blockSize);
+                            engine.process(buffer, 0, blockSize);
+                        });
+                };
+
+            for (const auto lowestPeak : { 100.0, 1000.0 })
+            {
+                for (const auto numPeaks : { 4, 8, 16, 24 })
+                {
+                    const auto chain = makeChain(sampleRate, 0, numPeaks, Design_Bilinear, lowestPeak);
+
+                    MultichannelCascade<SampleType> cascade;
+                    cascade.prepare((size_t)numChannels, blockSize);
+                    cascade.setCoefficients(chain);
+
+                    MultichannelCascade<SampleType, SvfCascade> svf;
+                    svf.prepare((size_t)numChannels, blockSize);
+                    svf.setCoefficients(makeSvfChain(chain), 0);
+
+                    ParallelCascade<SampleType> parallel;
+                    parallel.prepare((size_t)numChannels, blockSize);
+                    parallel.setCoefficients(chain);
+
+                    const auto cascadeTime = time(cascade);
+                    const auto svfTime = time(svf);
+                    const auto parallelTime = time(parallel);
+
+                    std::printf("  %5.0f Hz  %8d  %8d  %7.2f  %7.2f  %8.2f\n", lowestPeak, numChannels, numPeaks, cascadeTime, svfTime, parallelTime);
+                }
+            }
+        }
+
+        std::printf("\n");
+    }
+
+    void benchmarkEngines()
+    {
+        benchmarkEnginesFor<float>("float");
+        benchmarkEnginesFor<double>("double");
+    }
+
+    //==============================================================================
+    // Pior caso da forma paralela: 24 peaks e cortes de 96 dB/oct (40 seções), com
+    // a suavização mudando o ganho de todas as bandas a cada ponto da grade. Cada
+    // mudança refaz a expansão, O(n^2) nas seções; "repeated" reenvia a mesma cadeia,
+    // que não é expandida de novo. Em float a expansão não passa na conferência e a
+    // cadeia roda na cascata, mas cada mudança ainda tenta a volta à forma paralela.
+    template<typename SampleType>
+    void benchmarkSmoothingFor(const char* typeName)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        constexpr int interval = 32;
+        constexpr int numChannels = 2;
+        constexpr int numSteps = 256;
+
+        // Passos da suavização, calculados antes para medir só os motores
+        std::vector<ChainCoefficients> steps;
+
+        for (int step = 0; step < numSteps; ++step)
+        {
+            auto chain = makeChain(sampleRate, 16, maxPeakBands);
+            const auto gain = 1.0 + 0.5 * std::sin(juce::MathConstants<double>::twoPi * step / numSteps);
+
+            for (int band = 0; band < maxPeakBands; ++band)
+            {
+                const auto frequency = 100.0 * std::pow(12000.0 / 100.0, (double)band / maxPeakBands);
+                chain.peaks.bands[(size_t)band] = makePeakCoefficients(sampleRate, frequency, 1.0, band % 2 == 0 ? gain : 1.0 / gain, Design_Bilinear);
+            }
+
+            steps.push_back(chain);
+        }
+
+        const auto noise = makeNoise<SampleType>(numChannels, blockSize);
+        juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+
+        std::printf("smoothing: 40 sections (96 dB/oct cuts, %d peaks), stereo %s, block %d, update every %d samples, ns per sample per channel\n",
+                    maxPeakBands, typeName, blockSize, interval);
+        std::printf("  engine     static  smoothing  repeated\n");
+
+        auto run = [&](const char* name, auto& engine)
+            {
+                int step = 0;
+
+                const auto still = measure(blockSize, numChannels, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+                        engine.process(buffer, 0, blockSize);
+                    });
+
+                const auto smoothing = measure(blockSize, numChannels, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+
+                        for (int start = 0; start < blockSize; start += interval)
+                        {
+                            engine.setCoefficients(steps[(size_t)(step++ % numSteps)], interval);
+                            engine.process(buffer, start, interval);
+                        }
+                    });
+
+                const auto repeated = measure(blockSize, numChannels, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+
+                        for (int start = 0; start < blockSize; start += interval)
+                        {
+                            engine.setCoefficients(steps[0], interval);
+                            engine.process(buffer, start, interval);
+                        }
+                    });
+
+                std::printf("  %-8s  %7.2f  %9.2f  %8.2f\n", name, still, smoothing, repeated);
+            };
+
+        MultichannelCascade<SampleType> cascade;
+        cascade.prepare(numChannels, blockSize);
+        cascade.setCoefficients(steps[0]);
+        run("cascade", cascade);
+
+        ParallelCascade<SampleType> parallel;
+        parallel.prepare(numChannels, blockSize);
+        parallel.setCoefficients(steps[0]);
+        run("parallel", parallel);
+
+        std::printf("\n");
+    }
+
+    void benchmarkSmoothing()
+    {
+        benchmarkSmoothingFor<float>("float");
+        benchmarkSmoothingFor<double>("double");
+    }
+
+    //==============================================================================
+    // Um canal sozinho: processSingleLane(), que põe as faixas do registrador ao
+    // longo do tempo, contra a recursão escalar amostra por amostra (forma direta
+    // transposta II, seção por seção) e contra process() com o canal na faixa 0 e
+    // as outras paradas. A MultichannelCascade usa o primeiro só com quatro faixas
+    // ou mais. Só bandas peak, a partir de 1 kHz, para que em float nenhuma seção
+    // passe ao SVF, que roda em escalar nos dois caminhos.
+    template<typename SampleType>
+    void benchmarkSingleFor(const char* typeName)
+    {
+        using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int maxBlockSize = 1024;
+
+        struct Section
+        {
+            SampleType b0, b1, b2, a1, a2, s1, s2;
+        };
+
+        const auto noise = makeNoise<SampleType>(1, maxBlockSize);
+        juce::AudioBuffer<SampleType> buffer(1, maxBlockSize);
+
+        // As faixas que não são a 0 ficam em zero, e os filtros as mantêm em zero
+        std::vector<Vec> lanes((size_t)maxBlockSize, Vec::expand(SampleType()));
+
+        std::printf("single: one channel, %s, peak bands only, ns per sample\n", typeName);
+        std::printf("  sections  block   scalar   lane 0  single lane\n");
+
+        for (const auto numSections : { 4, 8, 16 })
+        {
+            const auto chain = makeChain(sampleRate, 0, numSections, Design_Bilinear, 1000.0);
+
+            std::vector<Section> sections;
+            for (int band = 0; band < numSections; ++band)
+            {
+                const auto& c = chain.peaks.bands[(size_t)band];
+                sections.push_back({ (SampleType)c.b0, (SampleType)c.b1, (SampleType)c.b2, (SampleType)c.a1, (SampleType)c.a2, SampleType(), SampleType() });
+            }
+
+            BiquadCascade<Vec> laneZero;
+            laneZero.setCoefficients(chain);
+
+            BiquadCascade<Vec> single;
+            single.setCoefficients(chain);
+
+            for (int blockSize = 32; blockSize <= maxBlockSize; blockSize *= 2)
+            {
+                const auto scalarTime = measure(blockSize, 1, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+                        auto* samples = buffer.getWritePointer(0);
+
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            auto x = samples[i];
+
+                            for (auto& section : sections)
+                            {
+                                const auto y = section.b0 * x + section.s1;
+                                section.s1 = section.b1 * x - section.a1 * y + section.s2;
+                                section.s2 = section.b2 * x - section.a2 * y;
+                                x = y;
+                            }
+
+                            samples[i] = x;
+                        }
+                    });
+
+                const auto laneZeroTime = measure(blockSize, 1, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+                        auto* samples = buffer.getWritePointer(0);
+
+                        for (int i = 0; i < blockSize; ++i)
+                            SampleLanes<Vec>::set(lanes[(size_t)i], 0, samples[i]);
+
+                        laneZero.process(lanes.data(), (size_t)blockSize);
+
+                        for (int i = 0; i < blockSize; ++i)
+                            samples[i] = SampleLanes<Vec>::get(lanes[(size_t)i], 0);
+                    });
+
+                const auto singleTime = measure(blockSize, 1, [&]
+                    {
+                        copyInput(buffer, noise, blockSize);
+                        single.processSingleLane(buffer.getWritePointer(0), (size_t)blockSize);
+                    });
+
+                std::printf("  %8d  %5d  %7.2f  %7.2f  %11.2f\n", numSections, blockSize, scalarTime, laneZeroTime, singleTime);
+            }
+        }
+
+        std::printf("\n");
+    }
+
+    void benchmarkSingle()
+    {
+        benchmarkSingleFor<float>("float");
+        benchmarkSingleFor<double>("double");
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    const std::pair<const char*, void (*)()> sections[] = {
+        { "cascade", benchmarkCascade },
+        { "grid", benchmarkGrid },
+        { "precision", benchmarkPrecision },
+        { "convolver", benchmarkConvolver },
+        { "oversampling", benchmarkOversampling },
+        { "matched", benchmarkMatched },
+        { "engines", benchmarkEngines },
+        { "smoothing", benchmarkSmoothing },
+        { "single", benchmarkSingle }
+    };
+
+    for (const auto& [name, run] : sections)
+    {
+        auto selected = argc == 1;
+        for (int i = 1; i < argc; ++i)
+            selected = selected || std::strcmp(argv[i], name) == 0;
+
+        if (selected)
+            run();
+    }
+
+    return 0;
+}
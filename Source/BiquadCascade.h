@@ -0,0 +1,1042 @@
+/*
+  ==============================================================================
+
+    Cascata de seções biquad processada em uma única passagem.
+
+    Em vez de cada filtro percorrer o bloco inteiro (como em um
+    juce::dsp::ProcessorChain), cada amostra atravessa todas as seções ativas
+    de uma vez, com o estado dos filtros em variáveis locais. Seções desligadas
+    não fazem parte da lista, então não há teste de bypass por amostra.
+
+    Uma seção que volta à lista entra com um crossfade a partir da identidade:
+    o numerador é interpolado de A(z) a B(z) amostra a amostra, com o denominador
+    fixo. Com o peso w parado a saída seria x + w (y - x); como o estado guarda os
+    pesos anteriores, a transição real é suave mas um pouco atrasada em relação a ela.
+
+    O número de seções ativas é um parâmetro de template do kernel, que é
+    escolhido só quando esse número muda (ou seja, quando muda a inclinação de
+    um dos cortes ou uma banda é ligada ou desligada), permitindo ao compilador
+    desenrolar o laço das seções. As seções ativas ficam compactadas no início
+    dos arrays de coeficientes e de estado, na ordem da cadeia.
+
+    Em float, a forma direta perde precisão quando os polos ficam muito perto
+    de z = 1 (um LowCut em 20 Hz a 192 kHz, por exemplo): a1 e a2 quase se
+    cancelam e o erro de arredondamento move os polos. Essas seções são
+    escolhidas pela distância dos polos a DC e a Nyquist e processadas como
+    TPT SVF, cujos coeficientes continuam bem condicionados, antes das demais
+    (a ordem não muda a resposta de uma cascata linear). Em double todas as
+    seções usam a forma direta.
+
+    Um grupo com um único canal (mono, ou o que sobra de 5.1 em registradores
+    de 4) deixaria ociosas as outras faixas. Nele a forma direta é calculada em
+    blocos de Vec::size() amostras: as saídas do bloco saem de uma vez, como a
+    soma das respostas ao impulso deslocadas (uma coluna por amostra de entrada)
+    e das respostas ao estado inicial, pré-calculadas por seção. O estado ao fim
+    do bloco vem das duas últimas entradas e saídas, pela própria recursão.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadDesign.h"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+// Canais de um par estéreo afetados por uma seção: os dois, só o primeiro
+// (esquerdo ou mid, a faixa 0 do registrador) ou só o segundo (direito ou side,
+// as demais faixas). Nos canais não afetados a seção é a identidade.
+enum StereoPlacement
+{
+    Placement_Both,
+    Placement_First,
+    Placement_Second
+};
+
+//==============================================================================
+// Operações que dependem do tipo de amostra: float/double ou um SIMDRegister,
+// em que cada faixa do registrador é um canal diferente.
+template<typename SampleType>
+struct SampleLanes
+{
+    using ElementType = SampleType;
+
+    static constexpr size_t size() noexcept { return 1; }
+
+    static SampleType broadcast(double value) noexcept { return static_cast<SampleType>(value); }
+
+    static ElementType get(const SampleType& value, size_t) noexcept { return value; }
+    static void set(SampleType& value, size_t, ElementType element) noexcept { value = element; }
+
+    // 'value' nas faixas que a seção afeta e 'identity' nas outras
+    static SampleType place(double value, double identity, StereoPlacement placement) noexcept
+    {
+        return static_cast<SampleType>(placement == Placement_Second ? identity : value);
+    }
+};
+
+template<typename ElementType_>
+struct SampleLanes<juce::dsp::SIMDRegister<ElementType_>>
+{
+    using ElementType = ElementType_;
+
+    static constexpr size_t size() noexcept { return juce::dsp::SIMDRegister<ElementType>::size(); }
+
+    static juce::dsp::SIMDRegister<ElementType> broadcast(double value) noexcept
+    {
+        return juce::dsp::SIMDRegister<ElementType>::expand(static_cast<ElementType>(value));
+    }
+
+    static ElementType get(const juce::dsp::SIMDRegister<ElementType>& value, size_t lane) noexcept { return value.get(lane); }
+    static void set(juce::dsp::SIMDRegister<ElementType>& value, size_t lane, ElementType element) noexcept { value.set(lane, element); }
+
+    static juce::dsp::SIMDRegister<ElementType> place(double value, double identity, StereoPlacement placement) noexcept
+    {
+        if (placement == Placement_Both)
+            return broadcast(value);
+
+        auto lanes = broadcast(placement == Placement_First ? identity : value);
+        lanes.set(0, static_cast<ElementType>(placement == Placement_First ? value : identity));
+        return lanes;
+    }
+};
+
+// Se a faixa 'lane' do registrador é afetada por uma seção com esse posicionamento
+inline bool affectsLane(StereoPlacement placement, size_t lane) noexcept
+{
+    return placement == Placement_Both || (placement == Placement_First) == (lane == 0);
+}
+
+//==============================================================================
+// Número máximo de bandas paramétricas (peak) entre os dois cortes
+constexpr int maxPeakBands = 24;
+
+// Uma seção por banda; bandas desligadas ficam fora da cascata
+struct PeakBandCoefficients
+{
+    std::array<BiquadCoefficients, maxPeakBands> bands;
+    std::array<bool, maxPeakBands> active{};
+    std::array<StereoPlacement, maxPeakBands> placement{};
+};
+
+// Coeficientes de toda a cadeia LowCut -> Peaks -> HighCut
+struct ChainCoefficients
+{
+    CutFilterCoefficients lowCut, highCut;
+    PeakBandCoefficients peaks;
+
+    // Canais afetados por todas as seções de cada corte
+    StereoPlacement lowCutPlacement{ Placement_Both }, highCutPlacement{ Placement_Both };
+
+    double getMagnitudeForFrequency(double frequency, double sampleRate) const
+    {
+        auto magnitude = 1.0;
+
+        for (int i = 0; i < maxPeakBands; ++i)
+            if (peaks.active[(size_t)i])
+                magnitude *= peaks.bands[(size_t)i].getMagnitudeForFrequency(frequency, sampleRate);
+
+        for (int i = 0; i < lowCut.numSections; ++i)
+            magnitude *= lowCut.sections[(size_t)i].getMagnitudeForFrequency(frequency, sampleRate);
+
+        for (int i = 0; i < highCut.numSections; ++i)
+            magnitude *= highCut.sections[(size_t)i].getMagnitudeForFrequency(frequency, sampleRate);
+
+        return magnitude;
+    }
+
+    // Duração da cauda da cadeia: com as seções em série, a soma das caudas é um
+    // limite conservador (a medida costuma ficar bem abaixo dele)
+    double getDecaySamples(double attenuationDb) const
+    {
+        auto samples = 0.0;
+
+        for (int i = 0; i < maxPeakBands; ++i)
+            if (peaks.active[(size_t)i])
+                samples += peaks.bands[(size_t)i].getDecaySamples(attenuationDb);
+
+        for (int i = 0; i < lowCut.numSections; ++i)
+            samples += lowCut.sections[(size_t)i].getDecaySamples(attenuationDb);
+
+        for (int i = 0; i < highCut.numSections; ++i)
+            samples += highCut.sections[(size_t)i].getDecaySamples(attenuationDb);
+
+        return samples;
+    }
+};
+
+//==============================================================================
+// Forma direta transposta II, a mesma de juce::dsp::IIR::Filter, com os
+// coeficientes e o estado guardados como estrutura de arrays. Em float, as
+// seções com polos perto de DC ou de Nyquist usam um TPT SVF.
+template<typename SampleType>
+class BiquadCascade
+{
+public:
+    // LowCut (até 8 seções), as bandas peak e HighCut (até 8 seções)
+    static constexpr int maxSections = 2 * maxCutFilterSections + maxPeakBands;
+
+    using ElementType = typename SampleLanes<SampleType>::ElementType;
+    static constexpr size_t numLanes = SampleLanes<SampleType>::size();
+
+    // Uma seção passa ao SVF quando getPoleClearance() cai abaixo do primeiro
+    // limite e só volta à forma direta acima do segundo, para não alternar a
+    // cada recálculo perto da fronteira
+    static constexpr bool usesRobustSections = std::is_same_v<ElementType, float>;
+    static constexpr double robustEntryClearance = 1.0e-3;
+    static constexpr double robustExitClearance = 4.0e-3;
+
+    void reset() noexcept
+    {
+        for (auto& slot : slots)
+            slot.s1 = slot.s2 = SampleType();
+
+        for (int i = 0; i < numActive; ++i)
+            s1[(size_t)i] = s2[(size_t)i] = SampleType();
+
+        for (int i = 0; i < numRobust; ++i)
+            ic1[(size_t)i] = ic2[(size_t)i] = SampleType();
+    }
+
+    // Recebe os coeficientes de toda a cadeia e monta a lista compacta de seções ativas.
+    // Seções que acabaram de ser ligadas partem do estado zero e entram com um
+    // crossfade nas próximas fadeLength amostras (com zero, imediatamente, no estado
+    // que tinham). As que acabaram de ser desligadas saem pelo crossfade inverso, com
+    // os últimos coeficientes que tiveram, e só então deixam a lista (com zero,
+    // imediatamente). Não aloca memória; pode ser chamado na thread de áudio entre dois blocos.
+    void setCoefficients(const ChainCoefficients& chain, int fadeLength = 0) noexcept
+    {
+        saveActiveState();
+
+        int slot = 0;
+        auto setCut = [this, &slot](const CutFilterCoefficients& cut, StereoPlacement placement)
+            {
+                for (int i = 0; i < maxCutFilterSections; ++i, ++slot)
+                    setSlot(slot, cut.sections[(size_t)i], i < cut.numSections, placement);
+            };
+
+        setCut(chain.lowCut, chain.lowCutPlacement);
+
+        for (int i = 0; i < maxPeakBands; ++i, ++slot)
+            setSlot(slot, chain.peaks.bands[(size_t)i], chain.peaks.active[(size_t)i], chain.peaks.placement[(size_t)i]);
+
+        setCut(chain.highCut, chain.highCutPlacement);
+
+        jassert(slot == maxSections);
+        rebuildActiveSections(juce::jmax(0, fadeLength));
+    }
+
+    // Uma única seção no lugar da cadeia (por exemplo, o passa-banda de um detector)
+    void setCoefficients(const BiquadCoefficients& section) noexcept
+    {
+        saveActiveState();
+
+        for (int i = 0; i < maxSections; ++i)
+            setSlot(i, section, i == 0);
+
+        rebuildActiveSections(0);
+    }
+
+    // Verdadeiro enquanto alguma seção entra ou sai pelo crossfade
+    bool isFading() const noexcept { return !fadeFinished; }
+
+    // Processa um canal só, na faixa 0, sem intercalar: 'samples' são as amostras
+    // do canal. As outras faixas ficam paradas. Só para SIMDRegister.
+    void processSingleLane(ElementType* samples, size_t numSamples) noexcept
+    {
+        static_assert(numLanes >= 2, "O bloco precisa de pelo menos duas faixas");
+
+        size_t i = 0;
+
+        // O crossfade muda os numeradores a cada amostra: passa pelo caminho normal,
+        // com a amostra na faixa 0 de cada registrador
+        while (i < numSamples && fadeRemaining > 0)
+        {
+            std::array<SampleType, 32> fading;
+            const auto count = juce::jmin(fading.size(), numSamples - i, (size_t)fadeRemaining);
+
+            for (size_t n = 0; n < count; ++n)
+            {
+                fading[n] = SampleType();
+                SampleLanes<SampleType>::set(fading[n], 0, samples[i + n]);
+            }
+
+            process(fading.data(), count);
+
+            for (size_t n = 0; n < count; ++n)
+                samples[i + n] = SampleLanes<SampleType>::get(fading[n], 0);
+
+            i += count;
+        }
+
+        if (fadeRemaining == 0 && !fadeFinished)
+            finishFade();
+
+        processRobustSingleLane(samples + i, numSamples - i);
+        processBlocks(samples + i, numSamples - i);
+    }
+
+    void process(SampleType* samples, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+        // Durante o crossfade os numeradores avançam a cada amostra, sem o kernel
+        // especializado; nas seções que não estão entrando o incremento é zero
+        for (; i < numSamples && fadeRemaining > 0; ++i, --fadeRemaining)
+        {
+            auto x = samples[i];
+
+            for (size_t s = 0; s < (size_t)numRobust; ++s)
+            {
+                m0[s] += dm0[s];
+                m1[s] += dm1[s];
+                m2[s] += dm2[s];
+
+                x = tickRobust(x, s);
+            }
+
+            for (size_t s = 0; s < (size_t)numActive; ++s)
+            {
+                b0[s] += db0[s];
+                b1[s] += db1[s];
+                b2[s] += db2[s];
+
+                auto y = b0[s] * x + s1[s];
+                s1[s] = b1[s] * x - a1[s] * y + s2[s];
+                s2[s] = b2[s] * x - a2[s] * y;
+                x = y;
+            }
+
+            samples[i] = x;
+        }
+
+        if (fadeRemaining == 0 && !fadeFinished)
+            finishFade();
+
+        // Seção por seção no resto do bloco; costumam ser poucas (os cortes graves)
+        for (size_t s = 0; s < (size_t)numRobust; ++s)
+            for (auto n = i; n < numSamples; ++n)
+                samples[n] = tickRobust(samples[n], s);
+
+        kernel(*this, samples + i, numSamples - i);
+    }
+
+private:
+    // Seções SVF de processSingleLane(), em escalar na faixa 0
+    void processRobustSingleLane(ElementType* samples, size_t numSamples) noexcept
+    {
+        using Lanes = SampleLanes<SampleType>;
+
+        for (size_t s = 0; s < (size_t)numRobust; ++s)
+        {
+            const auto c1 = Lanes::get(g1[s], 0), c2 = Lanes::get(g2[s], 0), c3 = Lanes::get(g3[s], 0);
+            const auto d0 = Lanes::get(m0[s], 0), d1 = Lanes::get(m1[s], 0), d2 = Lanes::get(m2[s], 0);
+            auto z1 = Lanes::get(ic1[s], 0), z2 = Lanes::get(ic2[s], 0);
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto x = samples[i];
+                const auto v3 = x - z2;
+                const auto v1 = c1 * z1 + c2 * v3;
+                const auto v2 = z2 + c2 * z1 + c3 * v3;
+
+                z1 = v1 + v1 - z1;
+                z2 = v2 + v2 - z2;
+                samples[i] = d0 * x + d1 * v1 + d2 * v2;
+            }
+
+            Lanes::set(ic1[s], 0, z1);
+            Lanes::set(ic2[s], 0, z2);
+        }
+    }
+
+    // Estado da seção na faixa 0, em escalar, durante processBlocks()
+    struct LaneState
+    {
+        ElementType z1, z2;
+    };
+
+    // Seções na forma direta de processSingleLane(), numLanes saídas por vez, cada
+    // seção no trecho todo antes da seguinte. A entrada de cada bloco já está pronta
+    // (é a saída da seção anterior) e de um bloco para o seguinte só passam os dois
+    // estados. As seções vão em pares, a segunda um bloco atrás da primeira, para que
+    // as duas recursões de estado, independentes, se sobreponham no processador. As
+    // amostras que não completam um bloco seguem a recursão escalar.
+    void processBlocks(ElementType* samples, size_t numSamples) noexcept
+    {
+        using Lanes = SampleLanes<SampleType>;
+
+        if (blockResponsesDirty)
+            updateBlockResponses();
+
+        const auto blockEnd = numSamples - numSamples % numLanes;
+
+        for (size_t s = 0; s < (size_t)numActive; s += 2)
+        {
+            const auto paired = s + 1 < (size_t)numActive;
+            LaneState first{ Lanes::get(s1[s], 0), Lanes::get(s2[s], 0) }, second{};
+
+            if (paired)
+                second = { Lanes::get(s1[s + 1], 0), Lanes::get(s2[s + 1], 0) };
+
+            for (size_t i = 0; i < blockEnd; i += numLanes)
+            {
+                processBlock(s, samples + i, first);
+
+                if (paired && i > 0)
+                    processBlock(s + 1, samples + i - numLanes, second);
+            }
+
+            processRemainder(s, samples + blockEnd, numSamples - blockEnd, first);
+            Lanes::set(s1[s], 0, first.z1);
+            Lanes::set(s2[s], 0, first.z2);
+
+            if (paired)
+            {
+                if (blockEnd > 0)
+                    processBlock(s + 1, samples + blockEnd - numLanes, second);
+
+                processRemainder(s + 1, samples + blockEnd, numSamples - blockEnd, second);
+                Lanes::set(s1[s + 1], 0, second.z1);
+                Lanes::set(s2[s + 1], 0, second.z2);
+            }
+        }
+    }
+
+    // Um bloco de numLanes amostras pela seção s: as saídas e os estados seguintes
+    // são combinações das entradas e dos estados atuais
+    void processBlock(size_t s, ElementType* samples, LaneState& state) noexcept
+    {
+        using Lanes = SampleLanes<SampleType>;
+
+        const auto& response = blockResponses[s];
+        const auto& next = stateResponses[s];
+
+        auto y = response[0] * SampleType::expand(samples[0]);
+        auto z = next[0] * SampleType::expand(samples[0]);
+
+        for (size_t k = 1; k < numLanes; ++k)
+        {
+            const auto x = SampleType::expand(samples[k]);
+            y += response[k] * x;
+            z += next[k] * x;
+        }
+
+        const auto w1 = SampleType::expand(state.z1), w2 = SampleType::expand(state.z2);
+        y += response[numLanes] * w1 + response[numLanes + 1] * w2;
+        z += next[numLanes] * w1 + next[numLanes + 1] * w2;
+
+        state = { Lanes::get(z, 0), Lanes::get(z, 1) };
+
+        alignas(alignof(SampleType)) std::array<ElementType, numLanes> block;
+        y.copyToRawArray(block.data());
+        std::copy(block.begin(), block.end(), samples);
+    }
+
+    // As amostras que não completam um bloco, pela recursão escalar da seção s
+    void processRemainder(size_t s, ElementType* samples, size_t numSamples, LaneState& state) noexcept
+    {
+        using Lanes = SampleLanes<SampleType>;
+
+        const auto c0 = Lanes::get(b0[s], 0), c1 = Lanes::get(b1[s], 0), c2 = Lanes::get(b2[s], 0);
+        const auto d1 = Lanes::get(a1[s], 0), d2 = Lanes::get(a2[s], 0);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto x = samples[i];
+            const auto y = c0 * x + state.z1;
+            state.z1 = c1 * x - d1 * y + state.z2;
+            state.z2 = c2 * x - d2 * y;
+            samples[i] = y;
+        }
+    }
+
+    // Por seção, a resposta a um bloco de numLanes amostras como combinação das
+    // entradas e dos dois estados. Em blockResponses, a coluna k tem na faixa n a
+    // resposta ao impulso h[n - k] (zero para n < k) e as duas últimas, a resposta
+    // sem entrada aos estados (1, 0) e (0, 1); em stateResponses, as mesmas colunas
+    // com os estados ao fim do bloco nas faixas 0 e 1. Calculadas em double a
+    // partir dos coeficientes da faixa 0.
+    void updateBlockResponses() noexcept
+    {
+        using Lanes = SampleLanes<SampleType>;
+
+        for (size_t s = 0; s < (size_t)numActive; ++s)
+        {
+            const auto c0 = (double)Lanes::get(b0[s], 0), c1 = (double)Lanes::get(b1[s], 0), c2 = (double)Lanes::get(b2[s], 0);
+            const auto d1 = (double)Lanes::get(a1[s], 0), d2 = (double)Lanes::get(a2[s], 0);
+
+            // Saídas do bloco a um impulso na posição impulseAt (numLanes: sem entrada)
+            // e, nas duas posições seguintes, os estados ao fim do bloco
+            auto respond = [&](size_t impulseAt, double state1, double state2)
+                {
+                    std::array<double, numLanes + 2> y;
+
+                    for (size_t n = 0; n < numLanes; ++n)
+                    {
+                        const auto x = n == impulseAt ? 1.0 : 0.0;
+                        y[n] = c0 * x + state1;
+                        state1 = c1 * x - d1 * y[n] + state2;
+                        state2 = c2 * x - d2 * y[n];
+                    }
+
+                    y[numLanes] = state1;
+                    y[numLanes + 1] = state2;
+                    return y;
+                };
+
+            auto toLanes = [](const std::array<double, numLanes + 2>& values)
+                {
+                    auto lanes = SampleType();
+                    for (size_t n = 0; n < numLanes; ++n)
+                        Lanes::set(lanes, n, (ElementType)values[n]);
+                    return lanes;
+                };
+
+            for (size_t k = 0; k < numLanes + 2; ++k)
+            {
+                const auto columns = k < numLanes ? respond(k, 0.0, 0.0)
+                                                  : respond(numLanes, k == numLanes ? 1.0 : 0.0, k == numLanes ? 0.0 : 1.0);
+
+                blockResponses[s][k] = toLanes(columns);
+
+                auto finalState = SampleType();
+                Lanes::set(finalState, 0, (ElementType)columns[numLanes]);
+                Lanes::set(finalState, 1, (ElementType)columns[numLanes + 1]);
+                stateResponses[s][k] = finalState;
+            }
+        }
+
+        blockResponsesDirty = false;
+    }
+
+    // Uma amostra do SVF da seção robusta s: saída m0 * entrada + m1 * passa-banda + m2 * passa-baixas
+    SampleType tickRobust(SampleType x, size_t s) noexcept
+    {
+        const auto v3 = x - ic2[s];
+        const auto v1 = g1[s] * ic1[s] + g2[s] * v3;
+        const auto v2 = ic2[s] + g2[s] * ic1[s] + g3[s] * v3;
+
+        ic1[s] = v1 + v1 - ic1[s];
+        ic2[s] = v2 + v2 - ic2[s];
+
+        return m0[s] * x + m1[s] * v1 + m2[s] * v2;
+    }
+
+    using Kernel = void (*)(BiquadCascade&, SampleType*, size_t) noexcept;
+
+    template<int NumSections>
+    static void processSections(BiquadCascade& cascade, SampleType* samples, size_t numSamples) noexcept
+    {
+        if constexpr (NumSections == 0)
+        {
+            juce::ignoreUnused(cascade, samples, numSamples);
+        }
+        else
+        {
+            // Cópias locais: o compilador pode mantê-las em registradores,
+            // já que não podem ser apelidos de 'samples'
+            std::array<SampleType, NumSections> c0, c1, c2, d1, d2, z1, z2;
+            for (size_t s = 0; s < (size_t)NumSections; ++s)
+            {
+                c0[s] = cascade.b0[s];
+                c1[s] = cascade.b1[s];
+                c2[s] = cascade.b2[s];
+                d1[s] = cascade.a1[s];
+                d2[s] = cascade.a2[s];
+                z1[s] = cascade.s1[s];
+                z2[s] = cascade.s2[s];
+            }
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto x = samples[i];
+
+                for (size_t s = 0; s < (size_t)NumSections; ++s)
+                {
+                    auto y = c0[s] * x + z1[s];
+                    z1[s] = c1[s] * x - d1[s] * y + z2[s];
+                    z2[s] = c2[s] * x - d2[s] * y;
+                    x = y;
+                }
+
+                samples[i] = x;
+            }
+
+            for (size_t s = 0; s < (size_t)NumSections; ++s)
+            {
+                cascade.s1[s] = z1[s];
+                cascade.s2[s] = z2[s];
+            }
+        }
+    }
+
+    template<size_t... NumSections>
+    static Kernel getKernel(int numSections, std::index_sequence<NumSections...>) noexcept
+    {
+        static constexpr Kernel kernels[] = { &processSections<(int)NumSections>... };
+        return kernels[numSections];
+    }
+
+    // Cada posição fixa da cadeia guarda seus coeficientes e, enquanto está
+    // desligada, o estado que tinha, como acontecia com o bypass do ProcessorChain.
+    // 'weight' é o peso do crossfade (1 na cadeia, 0 na identidade). 'leaving'
+    // marca uma seção desligada que ainda está saindo da lista. Com 'robust' o
+    // estado é o do SVF (ic1, ic2) em vez do da forma direta.
+    struct Slot
+    {
+        BiquadCoefficients coefficients;
+        bool active{ false }, wasActive{ false }, leaving{ false }, robust{ false };
+        StereoPlacement placement{ Placement_Both };
+        double weight{ 1.0 };
+        SampleType s1{}, s2{};
+    };
+
+    void setSlot(int index, const BiquadCoefficients& coefficients, bool active, StereoPlacement placement = Placement_Both) noexcept
+    {
+        auto& slot = slots[(size_t)index];
+        slot.wasActive = slot.active;
+        slot.active = active;
+
+        // Uma seção desligada sai com os coeficientes que tinha
+        if (active)
+        {
+            slot.coefficients = coefficients;
+            slot.placement = placement;
+        }
+    }
+
+    // Peso que o crossfade em andamento quer alcançar
+    static double getTargetWeight(const Slot& slot) noexcept { return slot.leaving ? 0.0 : 1.0; }
+
+    void saveActiveState() noexcept
+    {
+        // Fração do crossfade já percorrida desde o último rebuildActiveSections()
+        const auto progress = fadeLength > 0 ? 1.0 - (double)fadeRemaining / (double)fadeLength : 1.0;
+
+        for (int i = 0; i < numActive; ++i)
+        {
+            auto& slot = slots[(size_t)activeSlots[(size_t)i]];
+            slot.weight += (getTargetWeight(slot) - slot.weight) * progress;
+            slot.s1 = s1[(size_t)i];
+            slot.s2 = s2[(size_t)i];
+        }
+
+        for (int i = 0; i < numRobust; ++i)
+        {
+            auto& slot = slots[(size_t)robustSlots[(size_t)i]];
+            slot.weight += (getTargetWeight(slot) - slot.weight) * progress;
+            slot.s1 = ic1[(size_t)i];
+            slot.s2 = ic2[(size_t)i];
+        }
+    }
+
+    // Numerador A(z) + w (B(z) - A(z)); nas faixas que a seção não afeta, b0 = 1 e
+    // o resto zero, a identidade
+    void setNumerator(size_t s, const Slot& slot, double weight) noexcept
+    {
+        const auto& c = slot.coefficients;
+        b0[s] = SampleLanes<SampleType>::place(1.0 + weight * (c.b0 - 1.0), 1.0, slot.placement);
+        b1[s] = SampleLanes<SampleType>::place(c.a1 + weight * (c.b1 - c.a1), 0.0, slot.placement);
+        b2[s] = SampleLanes<SampleType>::place(c.a2 + weight * (c.b2 - c.a2), 0.0, slot.placement);
+    }
+
+    // No SVF a mistura é linear na saída: m0 = 1 e m1 = m2 = 0 é a identidade
+    void setMix(size_t s, const Slot& slot, const SvfCoefficients& svf, double weight) noexcept
+    {
+        m0[s] = SampleLanes<SampleType>::place(1.0 + weight * (svf.m0 - 1.0), 1.0, slot.placement);
+        m1[s] = SampleLanes<SampleType>::place(weight * svf.m1, 0.0, slot.placement);
+        m2[s] = SampleLanes<SampleType>::place(weight * svf.m2, 0.0, slot.placement);
+    }
+
+    static bool needsRobustSection(const BiquadCoefficients& coefficients, bool wasRobust) noexcept
+    {
+        if constexpr (usesRobustSections)
+        {
+            const auto clearance = coefficients.getPoleClearance();
+            return clearance > 0.0 && clearance < (wasRobust ? robustExitClearance : robustEntryClearance);
+        }
+        else
+        {
+            juce::ignoreUnused(coefficients, wasRobust);
+            return false;
+        }
+    }
+
+    // Troca a estrutura de uma seção sem descontinuidade: o novo estado é o que dá
+    // as mesmas duas próximas saídas com entrada zero (a resposta livre determina o
+    // estado de uma seção de segunda ordem). Nas faixas não afetadas, estado zero.
+    static void convertState(Slot& slot, bool toRobust) noexcept
+    {
+        const auto& c = slot.coefficients;
+        const auto svf = makeSvfCoefficients(c);
+        const auto svf1 = 1.0 / (1.0 + svf.g * (svf.g + svf.k));
+        const auto svf2 = svf.g * svf1;
+        const auto svf3 = svf.g * svf2;
+
+        // Duas saídas livres do SVF a partir de (ic1, ic2)
+        auto svfResponse = [&](double state1, double state2)
+            {
+                std::array<double, 2> y;
+
+                for (auto& output : y)
+                {
+                    const auto v1 = svf1 * state1 - svf2 * state2;
+                    const auto v2 = state2 + svf2 * state1 - svf3 * state2;
+                    output = svf.m1 * v1 + svf.m2 * v2;
+                    state1 = v1 + v1 - state1;
+                    state2 = v2 + v2 - state2;
+                }
+
+                return y;
+            };
+
+        const auto column1 = svfResponse(1.0, 0.0);
+        const auto column2 = svfResponse(0.0, 1.0);
+        const auto determinant = column1[0] * column2[1] - column2[0] * column1[1];
+
+        for (size_t lane = 0; lane < SampleLanes<SampleType>::size(); ++lane)
+        {
+            auto state1 = 0.0, state2 = 0.0;
+
+            if (affectsLane(slot.placement, lane))
+            {
+                const auto z1 = (double)SampleLanes<SampleType>::get(slot.s1, lane);
+                const auto z2 = (double)SampleLanes<SampleType>::get(slot.s2, lane);
+
+                if (toRobust && determinant != 0.0)
+                {
+                    // Saídas livres da forma direta: y0 = s1, y1 = s2 - a1 s1
+                    const auto y0 = z1;
+                    const auto y1 = z2 - c.a1 * z1;
+                    state1 = (y0 * column2[1] - column2[0] * y1) / determinant;
+                    state2 = (column1[0] * y1 - y0 * column1[1]) / determinant;
+                }
+                else if (!toRobust)
+                {
+                    const auto y0 = column1[0] * z1 + column2[0] * z2;
+                    const auto y1 = column1[1] * z1 + column2[1] * z2;
+                    state1 = y0;
+                    state2 = y1 + c.a1 * y0;
+                }
+            }
+
+            SampleLanes<SampleType>::set(slot.s1, lane, (ElementType)state1);
+            SampleLanes<SampleType>::set(slot.s2, lane, (ElementType)state2);
+        }
+    }
+
+    void addRobustSection(int index, const Slot& slot, int newFadeLength) noexcept
+    {
+        const auto s = (size_t)numRobust++;
+        robustSlots[s] = index;
+
+        const auto svf = makeSvfCoefficients(slot.coefficients);
+        setMix(s, slot, svf, slot.weight);
+
+        const auto step = newFadeLength > 0 ? (getTargetWeight(slot) - slot.weight) / newFadeLength : 0.0;
+        dm0[s] = SampleLanes<SampleType>::place(step * (svf.m0 - 1.0), 0.0, slot.placement);
+        dm1[s] = SampleLanes<SampleType>::place(step * svf.m1, 0.0, slot.placement);
+        dm2[s] = SampleLanes<SampleType>::place(step * svf.m2, 0.0, slot.placement);
+
+        const auto gain1 = 1.0 / (1.0 + svf.g * (svf.g + svf.k));
+        g1[s] = SampleLanes<SampleType>::place(gain1, 1.0, slot.placement);
+        g2[s] = SampleLanes<SampleType>::place(svf.g * gain1, 0.0, slot.placement);
+        g3[s] = SampleLanes<SampleType>::place(svf.g * svf.g * gain1, 0.0, slot.placement);
+        ic1[s] = slot.s1;
+        ic2[s] = slot.s2;
+    }
+
+    void rebuildActiveSections(int newFadeLength) noexcept
+    {
+        const auto previousNumActive = numActive;
+        numActive = numRobust = 0;
+
+        // O crossfade só é armado se alguma seção ainda não está no peso alvo
+        auto anyFading = false;
+
+        for (int index = 0; index < maxSections; ++index)
+        {
+            auto& slot = slots[(size_t)index];
+
+            if (slot.active)
+            {
+                // Uma seção que entra com crossfade parte da identidade, no estado
+                // zero; uma que estava saindo volta de onde está
+                if (!slot.wasActive && !slot.leaving && newFadeLength > 0)
+                {
+                    slot.weight = 0.0;
+                    slot.s1 = slot.s2 = SampleType();
+                }
+
+                slot.leaving = false;
+            }
+            else
+            {
+                // Uma seção desligada agora (ou ainda saindo) fica na lista até a identidade
+                slot.leaving = newFadeLength > 0 && (slot.wasActive || slot.leaving);
+
+                if (!slot.leaving)
+                    continue;
+            }
+
+            if (newFadeLength == 0)
+                slot.weight = 1.0;
+
+            anyFading = anyFading || slot.leaving || slot.weight != getTargetWeight(slot);
+
+            const auto robust = needsRobustSection(slot.coefficients, slot.robust);
+            if (robust != slot.robust)
+            {
+                convertState(slot, robust);
+                slot.robust = robust;
+            }
+
+            if (slot.robust)
+            {
+                addRobustSection(index, slot, newFadeLength);
+                continue;
+            }
+
+            const auto s = (size_t)numActive++;
+            activeSlots[s] = index;
+
+            setNumerator(s, slot, slot.weight);
+
+            const auto& c = slot.coefficients;
+            const auto step = newFadeLength > 0 ? (getTargetWeight(slot) - slot.weight) / newFadeLength : 0.0;
+            db0[s] = SampleLanes<SampleType>::place(step * (c.b0 - 1.0), 0.0, slot.placement);
+            db1[s] = SampleLanes<SampleType>::place(step * (c.b1 - c.a1), 0.0, slot.placement);
+            db2[s] = SampleLanes<SampleType>::place(step * (c.b2 - c.a2), 0.0, slot.placement);
+
+            a1[s] = SampleLanes<SampleType>::place(c.a1, 0.0, slot.placement);
+            a2[s] = SampleLanes<SampleType>::place(c.a2, 0.0, slot.placement);
+            s1[s] = slot.s1;
+            s2[s] = slot.s2;
+        }
+
+        // Uma simples troca de coeficientes não passa pelo caminho do crossfade
+        fadeLength = fadeRemaining = anyFading ? newFadeLength : 0;
+        fadeFinished = fadeRemaining == 0;
+        blockResponsesDirty = true;
+
+        // Troca de especialização apenas quando o número de seções muda
+        if (numActive != previousNumActive)
+            kernel = getKernel(numActive, std::make_index_sequence<maxSections + 1>());
+    }
+
+    // Fim do crossfade: fixa os numeradores no alvo, sem o erro acumulado dos
+    // incrementos, e tira da lista as seções que acabaram de sair
+    void finishFade() noexcept
+    {
+        auto anyLeaving = false;
+
+        for (int i = 0; i < numActive; ++i)
+        {
+            auto& slot = slots[(size_t)activeSlots[(size_t)i]];
+            slot.weight = getTargetWeight(slot);
+            setNumerator((size_t)i, slot, slot.weight);
+            anyLeaving = anyLeaving || slot.leaving;
+        }
+
+        for (int i = 0; i < numRobust; ++i)
+        {
+            auto& slot = slots[(size_t)robustSlots[(size_t)i]];
+            slot.weight = getTargetWeight(slot);
+            setMix((size_t)i, slot, makeSvfCoefficients(slot.coefficients), slot.weight);
+            anyLeaving = anyLeaving || slot.leaving;
+        }
+
+        fadeLength = 0;
+        fadeFinished = true;
+        blockResponsesDirty = true;
+
+        if (anyLeaving)
+        {
+            saveActiveState();
+
+            for (auto& slot : slots)
+                slot.leaving = false;
+
+            rebuildActiveSections(0);
+        }
+    }
+
+    std::array<Slot, maxSections> slots;
+
+    // Seções ativas, na ordem da cadeia
+    std::array<SampleType, maxSections> b0, b1, b2, a1, a2, s1, s2;
+    std::array<SampleType, maxSections> db0{}, db1{}, db2{};
+    std::array<int, maxSections> activeSlots{};
+    int numActive{ 0 };
+
+    // Seções robustas (SVF), também na ordem da cadeia
+    std::array<SampleType, maxSections> g1, g2, g3, m0, m1, m2, ic1, ic2;
+    std::array<SampleType, maxSections> dm0{}, dm1{}, dm2{};
+    std::array<int, maxSections> robustSlots{};
+    int numRobust{ 0 };
+
+    // Respostas de processSingleLane(), recalculadas quando os coeficientes mudam
+    std::array<std::array<SampleType, numLanes + 2>, maxSections> blockResponses, stateResponses;
+    bool blockResponsesDirty{ true };
+    int fadeLength{ 0 }, fadeRemaining{ 0 };
+    bool fadeFinished{ true };
+    Kernel kernel{ &processSections<0> };
+};
+
+//==============================================================================
+// Aplica a mesma cadeia a todos os canais de um AudioBuffer<SampleType>. Os canais
+// são agrupados de SIMDRegister<SampleType>::size() em SIMDRegister<SampleType>::size()
+// (4 floats ou 2 doubles com SSE/NEON, o dobro com AVX), um canal por faixa.
+// Cascade é o motor de filtro de cada grupo (BiquadCascade ou SvfCascade).
+// No modo mid/side os dois primeiros canais são codificados ao serem intercalados
+// e decodificados na volta, sem passagens extras pelo buffer.
+template<typename SampleType, template<typename> class Cascade = BiquadCascade>
+class MultichannelCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    // Aloca o estado de numChannels canais; com zero canais libera a memória
+    void prepare(size_t numChannels, size_t maximumBlockSize)
+    {
+        constexpr auto numLanes = Vec::size();
+
+        cascades.clear();
+        cascades.resize((numChannels + numLanes - 1) / numLanes);
+
+        if (numChannels > 0)
+        {
+            interleaved = juce::dsp::AudioBlock<Vec>(interleavedData, 1, maximumBlockSize);
+            interleaved.clear();
+        }
+        else
+        {
+            interleaved = {};
+            interleavedData.free();
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (auto& cascade : cascades)
+            cascade.reset();
+    }
+
+    // As faixas 0 e 1 do primeiro grupo passam a ser mid e side. O estado dos
+    // filtros não serve ao outro modo: chame reset() ao trocar.
+    void setMidSide(bool shouldUseMidSide) noexcept { midSide = shouldUseMidSide; }
+
+    // Repassa os argumentos ao setCoefficients() do motor de cada grupo
+    template<typename... Args>
+    void setCoefficients(const Args&... args) noexcept
+    {
+        for (auto& cascade : cascades)
+            cascade.setCoefficients(args...);
+    }
+
+    // Maior número de amostras aceito por process()
+    size_t getMaximumBlockSize() const noexcept { return interleaved.getNumSamples(); }
+
+    void process(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept
+    {
+        process(juce::dsp::AudioBlock<SampleType>(buffer).getSubBlock((size_t)startSample, (size_t)numSamples));
+    }
+
+    void process(const juce::dsp::AudioBlock<SampleType>& audio) noexcept
+    {
+        constexpr auto numLanes = Vec::size();
+        const auto numChannels = juce::jmin(audio.getNumChannels(), cascades.size() * numLanes);
+        const auto numSamples = (int)audio.getNumSamples();
+
+        jassert((size_t)numSamples <= getMaximumBlockSize());
+
+        auto block = interleaved.getSubBlock(0, (size_t)numSamples);
+        auto* lanes = reinterpret_cast<SampleType*>(block.getChannelPointer(0));
+
+        // Cada grupo de numLanes canais passa pela sua cascata, um canal por faixa do registrador
+        for (size_t group = 0; group * numLanes < numChannels; ++group)
+        {
+            const auto firstChannel = group * numLanes;
+            const auto numChannelsInGroup = juce::jmin(numLanes, numChannels - firstChannel);
+            const auto encoded = midSide && group == 0 && numChannelsInGroup >= 2;
+
+            // Um canal sozinho no grupo não precisa ser intercalado: os biquads o
+            // processam em blocos, com as faixas do registrador ao longo do tempo.
+            // Com duas faixas (double em SSE/NEON) o bloco custa mais que a própria
+            // recursão, e o canal fica na faixa 0 como os demais.
+            if constexpr (std::is_same_v<Cascade<Vec>, BiquadCascade<Vec>> && numLanes >= 4)
+            {
+                if (numChannelsInGroup == 1)
+                {
+                    cascades[group].processSingleLane(audio.getChannelPointer(firstChannel), (size_t)numSamples);
+                    continue;
+                }
+            }
+
+            if (encoded)
+            {
+                const auto* left = audio.getChannelPointer(0);
+                const auto* right = audio.getChannelPointer(1);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    lanes[(size_t)i * numLanes] = (left[i] + right[i]) * SampleType(0.5);
+                    lanes[(size_t)i * numLanes + 1] = (left[i] - right[i]) * SampleType(0.5);
+                }
+            }
+
+            // Intercala: a amostra i do canal ch vai para a faixa ch do i-ésimo registrador.
+            // As faixas sem canal ficam em zero e, como os filtros são lineares, continuam em zero.
+            for (size_t lane = encoded ? 2 : 0; lane < numLanes; ++lane)
+            {
+                if (lane < numChannelsInGroup)
+                {
+                    const auto* input = audio.getChannelPointer(firstChannel + lane);
+                    for (int i = 0; i < numSamples; ++i)
+                        lanes[(size_t)i * numLanes + lane] = input[i];
+                }
+                else
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                        lanes[(size_t)i * numLanes + lane] = SampleType();
+                }
+            }
+
+            cascades[group].process(block.getChannelPointer(0), (size_t)numSamples);
+
+            if (encoded)
+            {
+                auto* left = audio.getChannelPointer(0);
+                auto* right = audio.getChannelPointer(1);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto mid = lanes[(size_t)i * numLanes];
+                    const auto side = lanes[(size_t)i * numLanes + 1];
+                    left[i] = mid + side;
+                    right[i] = mid - side;
+                }
+            }
+
+            for (size_t lane = encoded ? 2 : 0; lane < numChannelsInGroup; ++lane)
+            {
+                auto* output = audio.getChannelPointer(firstChannel + lane);
+                for (int i = 0; i < numSamples; ++i)
+                    output[i] = lanes[(size_t)i * numLanes + lane];
+            }
+        }
+    }
+
+private:
+    std::vector<Cascade<Vec>> cascades;
+    bool midSide{ false };
+
+    // Amostras intercaladas (uma faixa SIMD por canal) de um grupo de canais
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<Vec> interleaved;
+};
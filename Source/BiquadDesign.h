@@ -0,0 +1,571 @@
+/*
+  ==============================================================================
+
+    Projeto de coeficientes biquad sem alocação de memória.
+
+    Os coeficientes são calculados em double e guardados em estruturas simples
+    (sem contagem de referências), para que possam ser recalculados na thread de
+    áudio e copiados para filtros já preparados sem chamar o alocador.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+//==============================================================================
+// Coeficientes normalizados de uma seção de segunda ordem (a0 = 1), na mesma
+// ordem usada por juce::dsp::IIR::Coefficients: b0, b1, b2, a1, a2.
+struct BiquadCoefficients
+{
+    double b0{ 1.0 }, b1{ 0.0 }, b2{ 0.0 }, a1{ 0.0 }, a2{ 0.0 };
+
+    // Magnitude da resposta em frequência, |H(e^jw)|, para a frequência dada em Hz
+    double getMagnitudeForFrequency(double frequency, double sampleRate) const
+    {
+        const auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const auto z = std::polar(1.0, -w); // z^-1
+
+        const auto numerator = b0 + z * (b1 + z * b2);
+        const auto denominator = 1.0 + z * (a1 + z * a2);
+
+        return std::abs(numerator / denominator);
+    }
+
+    // Amostras até a resposta ao impulso cair 'attenuationDb' abaixo do início,
+    // pelo raio do polo mais lento (r^n). Infinito se a seção não for estável.
+    double getDecaySamples(double attenuationDb) const
+    {
+        const auto discriminant = a1 * a1 - 4.0 * a2;
+        const auto radius = discriminant < 0.0 ? std::sqrt(a2)
+                                               : 0.5 * (std::abs(a1) + std::sqrt(discriminant));
+
+        if (radius >= 1.0)
+            return std::numeric_limits<double>::infinity();
+
+        // Polos na origem: só os zeros, duas amostras
+        if (radius <= 0.0)
+            return 2.0;
+
+        return 2.0 + std::log(juce::Decibels::decibelsToGain(-attenuationDb, -1000.0)) / std::log(radius);
+    }
+
+    // Menor entre 1 + a1 + a2 e 1 - a1 + a2, o denominador em z = 1 e em z = -1.
+    // Com polos complexos p é |1 - p|^2 (ou |1 + p|^2): tende a zero quando os
+    // polos se aproximam de DC ou de Nyquist, onde a forma direta perde precisão.
+    double getPoleClearance() const
+    {
+        return juce::jmin(1.0 + a1 + a2, 1.0 - a1 + a2);
+    }
+};
+
+// g = tan(pi * f / fs) é a frequência pré-distorcida, k = 1 / Q o amortecimento
+// e a saída é m0 * entrada + m1 * passa-banda + m2 * passa-baixas.
+struct SvfCoefficients
+{
+    double g{ 0.0 }, k{ 2.0 }, m0{ 1.0 }, m1{ 0.0 }, m2{ 0.0 };
+
+    // Os polos são os do denominador bilinear de s^2 + k s + 1
+    double getDecaySamples(double attenuationDb) const
+    {
+        const auto a0 = 1.0 + g * k + g * g;
+
+        BiquadCoefficients denominator;
+        denominator.a1 = 2.0 * (g * g - 1.0) / a0;
+        denominator.a2 = (1.0 - g * k + g * g) / a0;
+
+        return denominator.getDecaySamples(attenuationDb);
+    }
+};
+
+// Realiza uma seção biquad estável qualquer como SVF: desfaz a transformação
+// bilinear para obter o protótipo s^2 + k s + 1 (com a escala g escolhida para
+// normalizar o denominador) e resolve m0, m1, m2 para o numerador.
+inline SvfCoefficients makeSvfCoefficients(const BiquadCoefficients& biquad)
+{
+    const auto d0 = 1.0 + biquad.a1 + biquad.a2;
+    const auto d1 = 2.0 * (1.0 - biquad.a2);
+    const auto d2 = 1.0 - biquad.a1 + biquad.a2;
+
+    jassert(d0 > 0.0 && d2 > 0.0); // polos dentro do círculo unitário
+
+    const auto n0 = biquad.b0 + biquad.b1 + biquad.b2;
+    const auto n1 = 2.0 * (biquad.b0 - biquad.b2);
+    const auto n2 = biquad.b0 - biquad.b1 + biquad.b2;
+
+    const auto g = std::sqrt(d0 / d2);
+    const auto k = d1 / std::sqrt(d0 * d2);
+    const auto m0 = n2 / d2;
+
+    return { g, k, m0, n1 * g / d0 - m0 * k, n0 / d0 - m0 };
+}
+
+// Como os protótipos analógicos são levados ao domínio digital. A transformação
+// bilinear comprime a resposta perto de Nyquist; o casamento de magnitude (Vicanek,
+// "Matched Second Order Digital Filters") mantém os polos do protótipo e escolhe os
+// zeros para acertar a magnitude em até três pontos (DC, frequência central e
+// Nyquist; o passa-altas casa apenas a frequência central).
+enum DesignMethod
+{
+    Design_Bilinear,
+    Design_Matched
+};
+
+// Número máximo de seções de segunda ordem em um filtro de corte (96 dB/oct = ordem 16)
+constexpr int maxCutFilterSections = 8;
+
+// Famílias dos filtros de corte. Na mesma ordem, Chebyshev e elíptico trocam a
+// planura da banda passante por uma transição mais estreita: alcançam a mesma
+// rejeição com menos seções. No Butterworth e no Chebyshev II a frequência de
+// corte é o ponto de -3 dB; no Chebyshev I e no elíptico, a borda da ondulação.
+enum CutFilterFamily
+{
+    Family_Butterworth,
+    Family_ChebyshevI,
+    Family_ChebyshevII,
+    Family_Elliptic
+};
+
+// Ondulação na banda passante (Chebyshev I, elíptico) e atenuação mínima na
+// banda de rejeição (Chebyshev II, elíptico)
+constexpr double cutFilterPassbandRippleDb = 0.5;
+constexpr double cutFilterStopbandAttenuationDb = 60.0;
+
+// Seções de um filtro de corte de ordem par, uma por par de polos: Butterworth
+// (makeButterworthHighPass/LowPass) ou, pela bilinear do protótipo analógico,
+// Chebyshev I, Chebyshev II e elíptico (makePrototypeCutFilter)
+struct CutFilterCoefficients
+{
+    std::array<BiquadCoefficients, maxCutFilterSections> sections;
+    int numSections{ 0 };
+};
+
+//==============================================================================
+// Equivalente a juce::dsp::IIR::Coefficients<float>::makePeakFilter
+inline BiquadCoefficients makePeakCoefficients(double sampleRate, double frequency, double quality, double gainFactor)
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+    jassert(quality > 0.0);
+
+    const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    const auto alpha = std::sin(omega) / (quality * 2.0);
+    const auto c2 = -2.0 * std::cos(omega);
+    const auto alphaTimesA = alpha * A;
+    const auto alphaOverA = alpha / A;
+    const auto a0 = 1.0 + alphaOverA;
+
+    return { (1.0 + alphaTimesA) / a0, c2 / a0, (1.0 - alphaTimesA) / a0, c2 / a0, (1.0 - alphaOverA) / a0 };
+}
+
+// Equivalente a juce::dsp::IIR::Coefficients<float>::makeHighPass
+inline BiquadCoefficients makeHighPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+    jassert(quality > 0.0);
+
+    const auto n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / quality;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return { c1, c1 * -2.0, c1, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared) };
+}
+
+// Equivalente a juce::dsp::IIR::Coefficients<float>::makeLowPass
+inline BiquadCoefficients makeLowPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+    jassert(quality > 0.0);
+
+    const auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / quality;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return { c1, c1 * 2.0, c1, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared) };
+}
+
+// Equivalente a juce::dsp::IIR::Coefficients<float>::makeBandPass (ganho de 0 dB no pico)
+inline BiquadCoefficients makeBandPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+    jassert(quality > 0.0);
+
+    const auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / quality;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return { c1 * n * invQ, 0.0, -c1 * n * invQ, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared) };
+}
+
+//==============================================================================
+// Base comum dos projetos casados: polos por invariância ao impulso do protótipo
+// s^2 + s / quality + 1 e os termos de |A(e^jw)|^2 usados para casar a magnitude.
+struct MatchedPrototype
+{
+    MatchedPrototype(double sampleRate, double frequency, double quality)
+    {
+        jassert(sampleRate > 0.0);
+        jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+        jassert(quality > 0.0);
+
+        const auto w0 = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+        const auto q = 1.0 / (2.0 * quality);
+        const auto decay = std::exp(-q * w0);
+
+        a1 = q <= 1.0 ? -2.0 * decay * std::cos(std::sqrt(1.0 - q * q) * w0)
+                      : -2.0 * decay * std::cosh(std::sqrt(q * q - 1.0) * w0);
+        a2 = decay * decay;
+
+        const auto s = std::sin(w0 * 0.5);
+        phi1 = s * s;
+        phi0 = 1.0 - phi1;
+        phi2 = 4.0 * phi0 * phi1;
+
+        A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+        A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+        A2 = -4.0 * a2;
+    }
+
+    // |A(e^jw0)|^2 na frequência central
+    double getDenominatorAtCentre() const { return A0 * phi0 + A1 * phi1 + A2 * phi2; }
+
+    double a1, a2;
+    double phi0, phi1, phi2;
+    double A0, A1, A2;
+};
+
+// Mesma parametrização de makePeakCoefficients: o protótipo é
+// (s^2 + s A / Q + 1) / (s^2 + s / (A Q) + 1), com A = sqrt(gainFactor)
+inline BiquadCoefficients makeMatchedPeakCoefficients(double sampleRate, double frequency, double quality, double gainFactor)
+{
+    const auto G = juce::jmax(gainFactor, 1.0e-6);
+    const MatchedPrototype p(sampleRate, frequency, quality * std::sqrt(G));
+
+    const auto R1 = p.getDenominatorAtCentre() * G * G;
+    const auto R2 = (-p.A0 + p.A1 + 4.0 * (p.phi0 - p.phi1) * p.A2) * G * G;
+
+    const auto B0 = p.A0;
+    const auto B2 = (R1 - R2 * p.phi1 - B0) / (4.0 * p.phi1 * p.phi1);
+    const auto B1 = R2 + B0 + 4.0 * (p.phi1 - p.phi0) * B2;
+
+    const auto sqrtB0 = std::sqrt(B0);
+    const auto sqrtB1 = std::sqrt(juce::jmax(0.0, B1));
+    const auto W = 0.5 * (sqrtB0 + sqrtB1);
+
+    const auto b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+    const auto b1 = 0.5 * (sqrtB0 - sqrtB1);
+    const auto b2 = -B2 / (4.0 * b0);
+
+    return { b0, b1, b2, p.a1, p.a2 };
+}
+
+inline BiquadCoefficients makeMatchedHighPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    const MatchedPrototype p(sampleRate, frequency, quality);
+
+    const auto b0 = std::sqrt(juce::jmax(0.0, p.getDenominatorAtCentre())) * quality / (4.0 * p.phi1);
+    return { b0, -2.0 * b0, b0, p.a1, p.a2 };
+}
+
+inline BiquadCoefficients makeMatchedLowPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    const MatchedPrototype p(sampleRate, frequency, quality);
+
+    const auto R1 = p.getDenominatorAtCentre() * quality * quality;
+    const auto B0 = p.A0;
+    const auto B1 = (R1 - B0 * p.phi0) / p.phi1;
+
+    const auto sqrtB0 = std::sqrt(B0);
+    const auto b0 = 0.5 * (sqrtB0 + std::sqrt(juce::jmax(0.0, B1)));
+    return { b0, sqrtB0 - b0, 0.0, p.a1, p.a2 };
+}
+
+inline BiquadCoefficients makePeakCoefficients(double sampleRate, double frequency, double quality, double gainFactor, DesignMethod method)
+{
+    return method == Design_Matched ? makeMatchedPeakCoefficients(sampleRate, frequency, quality, gainFactor)
+                                    : makePeakCoefficients(sampleRate, frequency, quality, gainFactor);
+}
+
+//==============================================================================
+// Fator de qualidade da i-ésima seção de um Butterworth de ordem par,
+// o mesmo usado por juce::dsp::FilterDesign::design...HighOrderButterworthMethod
+inline double getButterworthSectionQuality(int section, int order)
+{
+    return 1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0)));
+}
+
+inline CutFilterCoefficients makeButterworthHighPass(double sampleRate, double frequency, int order, DesignMethod method = Design_Bilinear)
+{
+    jassert(order > 0 && order % 2 == 0 && order / 2 <= maxCutFilterSections);
+
+    CutFilterCoefficients cut;
+    cut.numSections = order / 2;
+
+    for (int i = 0; i < cut.numSections; ++i)
+    {
+        const auto quality = getButterworthSectionQuality(i, order);
+        cut.sections[(size_t)i] = method == Design_Matched ? makeMatchedHighPassCoefficients(sampleRate, frequency, quality)
+                                                           : makeHighPassCoefficients(sampleRate, frequency, quality);
+    }
+
+    return cut;
+}
+
+inline CutFilterCoefficients makeButterworthLowPass(double sampleRate, double frequency, int order, DesignMethod method = Design_Bilinear)
+{
+    jassert(order > 0 && order % 2 == 0 && order / 2 <= maxCutFilterSections);
+
+    CutFilterCoefficients cut;
+    cut.numSections = order / 2;
+
+    for (int i = 0; i < cut.numSections; ++i)
+    {
+        const auto quality = getButterworthSectionQuality(i, order);
+        cut.sections[(size_t)i] = method == Design_Matched ? makeMatchedLowPassCoefficients(sampleRate, frequency, quality)
+                                                           : makeLowPassCoefficients(sampleRate, frequency, quality);
+    }
+
+    return cut;
+}
+
+//==============================================================================
+// Protótipo analógico passa-baixas de ordem par, com corte em 1 rad/s, em pares
+// de polos (e zeros) conjugados: uma seção de segunda ordem por par. O ganho
+// leva o máximo da banda passante a 0 dB.
+struct AnalogPrototype
+{
+    std::array<std::complex<double>, maxCutFilterSections> poles, zeros;
+    int numSections{ 0 };
+    bool hasZeros{ false };
+    double gain{ 1.0 };
+};
+
+inline AnalogPrototype makeChebyshevIPrototype(int order)
+{
+    const auto pi = juce::MathConstants<double>::pi;
+    const auto epsilon = std::sqrt(std::pow(10.0, cutFilterPassbandRippleDb / 10.0) - 1.0);
+    const auto mu = std::asinh(1.0 / epsilon) / order;
+
+    AnalogPrototype prototype;
+    prototype.numSections = order / 2;
+
+    for (int i = 0; i < prototype.numSections; ++i)
+    {
+        const auto theta = pi * (2.0 * i + 1.0) / (2.0 * order);
+        prototype.poles[(size_t)i] = { -std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta) };
+    }
+
+    // Ordem par: DC fica no vale da ondulação
+    prototype.gain = 1.0 / std::sqrt(1.0 + epsilon * epsilon);
+    return prototype;
+}
+
+inline AnalogPrototype makeChebyshevIIPrototype(int order)
+{
+    const auto pi = juce::MathConstants<double>::pi;
+    const auto epsilon = 1.0 / std::sqrt(std::pow(10.0, cutFilterStopbandAttenuationDb / 10.0) - 1.0);
+    const auto mu = std::asinh(1.0 / epsilon) / order;
+
+    // A borda da banda de rejeição cai em 1 rad/s; a escala leva o ponto de -3 dB para lá
+    const auto scale = std::cosh(std::acosh(1.0 / epsilon) / order);
+
+    AnalogPrototype prototype;
+    prototype.numSections = order / 2;
+    prototype.hasZeros = true;
+
+    for (int i = 0; i < prototype.numSections; ++i)
+    {
+        const auto theta = pi * (2.0 * i + 1.0) / (2.0 * order);
+        const std::complex<double> inversePole{ -std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta) };
+
+        prototype.poles[(size_t)i] = scale / inversePole;
+        prototype.zeros[(size_t)i] = { 0.0, scale / std::cos(theta) };
+    }
+
+    return prototype;
+}
+
+// Funções elípticas de Jacobi pelas transformações de Landen, como em Orfanidis,
+// "Lecture Notes on Elliptic Filter Design". Os argumentos são normalizados pela
+// integral completa K (u = 1 corresponde a K).
+struct LandenSequence
+{
+    static constexpr int length = 8;
+
+    explicit LandenSequence(double k)
+    {
+        for (auto& v : moduli)
+        {
+            const auto kp = std::sqrt(1.0 - k * k);
+            k = (k / (1.0 + kp)) * (k / (1.0 + kp));
+            v = k;
+        }
+    }
+
+    // cd(u K, k) e sn(u K, k)
+    std::complex<double> cd(std::complex<double> u) const { return descend(std::cos(u * juce::MathConstants<double>::halfPi)); }
+    std::complex<double> sn(std::complex<double> u) const { return descend(std::sin(u * juce::MathConstants<double>::halfPi)); }
+
+    // Inversa de sn: u tal que sn(u K, k) = w
+    std::complex<double> asn(std::complex<double> w, double k) const
+    {
+        for (int n = 0; n < length; ++n)
+        {
+            const auto previous = n == 0 ? k : moduli[(size_t)(n - 1)];
+            w = w / (1.0 + std::sqrt(1.0 - w * w * previous * previous)) * 2.0 / (1.0 + moduli[(size_t)n]);
+        }
+
+        return std::asin(w) / juce::MathConstants<double>::halfPi;
+    }
+
+    std::complex<double> descend(std::complex<double> w) const
+    {
+        for (int n = length - 1; n >= 0; --n)
+            w = (1.0 + moduli[(size_t)n]) * w / (1.0 + moduli[(size_t)n] * w * w);
+
+        return w;
+    }
+
+    std::array<double, length> moduli;
+};
+
+inline AnalogPrototype makeEllipticPrototype(int order)
+{
+    const auto epsilonPass = std::sqrt(std::pow(10.0, cutFilterPassbandRippleDb / 10.0) - 1.0);
+    const auto epsilonStop = std::sqrt(std::pow(10.0, cutFilterStopbandAttenuationDb / 10.0) - 1.0);
+    const auto k1 = epsilonPass / epsilonStop;
+    const auto numSections = order / 2;
+
+    // Equação de grau: seletividade k que a ordem alcança com essas especificações
+    const auto k1Prime = std::sqrt(1.0 - k1 * k1);
+    const LandenSequence complementary(k1Prime);
+
+    auto product = 1.0;
+    for (int i = 1; i <= numSections; ++i)
+        product *= complementary.sn((2.0 * i - 1.0) / order).real();
+
+    const auto kPrime = std::pow(k1Prime, order) * std::pow(product, 4.0);
+    const auto k = std::sqrt(1.0 - kPrime * kPrime);
+
+    const LandenSequence selectivity(k);
+    const LandenSequence discrimination(k1);
+    const auto j = std::complex<double>(0.0, 1.0);
+    const auto v0 = -j * discrimination.asn(j / epsilonPass, k1) / (double)order;
+
+    AnalogPrototype prototype;
+    prototype.numSections = numSections;
+    prototype.hasZeros = true;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        const auto u = (2.0 * (i + 1) - 1.0) / order;
+        const auto zeta = selectivity.cd(u).real();
+        const auto pole = j * selectivity.cd(u - j * v0);
+
+        prototype.zeros[(size_t)i] = { 0.0, 1.0 / (k * zeta) };
+        prototype.poles[(size_t)i] = { -std::abs(pole.real()), std::abs(pole.imag()) };
+    }
+
+    prototype.gain = 1.0 / std::sqrt(1.0 + epsilonPass * epsilonPass);
+    return prototype;
+}
+
+inline AnalogPrototype makeAnalogPrototype(CutFilterFamily family, int order)
+{
+    jassert(family != Family_Butterworth);
+
+    switch (family)
+    {
+    case Family_ChebyshevI:  return makeChebyshevIPrototype(order);
+    case Family_ChebyshevII: return makeChebyshevIIPrototype(order);
+    case Family_Elliptic:    return makeEllipticPrototype(order);
+    default:                 return makeChebyshevIPrototype(order);
+    }
+}
+
+// Leva o protótipo à frequência dada pela transformação bilinear com pré-distorção,
+// uma seção por par de polos. No passa-altas s vira 1/s, o que inverte a ordem dos
+// coeficientes de cada seção analógica. O ganho vai para a primeira seção.
+inline CutFilterCoefficients makePrototypeCutFilter(const AnalogPrototype& prototype, double sampleRate, double frequency, bool highPass)
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+
+    const auto K = std::tan(juce::MathConstants<double>::pi * juce::jmin(frequency, sampleRate * 0.49) / sampleRate);
+
+    CutFilterCoefficients cut;
+    cut.numSections = prototype.numSections;
+
+    for (int i = 0; i < prototype.numSections; ++i)
+    {
+        const auto& pole = prototype.poles[(size_t)i];
+        const auto& zero = prototype.zeros[(size_t)i];
+
+        // Seção analógica (B0 s^2 + B1 s + B2) / (A0 s^2 + A1 s + A2) com ganho 1 em DC
+        const auto poleRadius = std::norm(pole);
+        const auto zeroRadius = prototype.hasZeros ? std::norm(zero) : 1.0;
+
+        auto A0 = 1.0, A1 = -2.0 * pole.real(), A2 = poleRadius;
+        auto B0 = prototype.hasZeros ? poleRadius / zeroRadius : 0.0;
+        auto B1 = 0.0;
+        auto B2 = poleRadius;
+
+        if (i == 0)
+        {
+            B0 *= prototype.gain;
+            B2 *= prototype.gain;
+        }
+
+        if (highPass)
+        {
+            std::swap(A0, A2);
+            std::swap(B0, B2);
+        }
+
+        // s = (1 - z^-1) / (K (1 + z^-1))
+        const auto d0 = A0 + A1 * K + A2 * K * K;
+        const auto d1 = 2.0 * (A2 * K * K - A0);
+        const auto d2 = A0 - A1 * K + A2 * K * K;
+        const auto n0 = B0 + B1 * K + B2 * K * K;
+        const auto n1 = 2.0 * (B2 * K * K - B0);
+        const auto n2 = B0 - B1 * K + B2 * K * K;
+
+        cut.sections[(size_t)i] = { n0 / d0, n1 / d0, n2 / d0, d1 / d0, d2 / d0 };
+    }
+
+    return cut;
+}
+
+// Filtros de corte de qualquer família. O projeto casado só existe para o
+// Butterworth; as demais famílias usam sempre a transformação bilinear.
+inline CutFilterCoefficients makeCutFilterHighPass(double sampleRate, double frequency, int order, CutFilterFamily family, DesignMethod method = Design_Bilinear)
+{
+    jassert(order > 0 && order % 2 == 0 && order / 2 <= maxCutFilterSections);
+
+    if (family == Family_Butterworth)
+        return makeButterworthHighPass(sampleRate, frequency, order, method);
+
+    return makePrototypeCutFilter(makeAnalogPrototype(family, order), sampleRate, frequency, true);
+}
+
+inline CutFilterCoefficients makeCutFilterLowPass(double sampleRate, double frequency, int order, CutFilterFamily family, DesignMethod method = Design_Bilinear)
+{
+    jassert(order > 0 && order % 2 == 0 && order / 2 <= maxCutFilterSections);
+
+    if (family == Family_Butterworth)
+        return makeButterworthLowPass(sampleRate, frequency, order, method);
+
+    return makePrototypeCutFilter(makeAnalogPrototype(family, order), sampleRate, frequency, false);
+}
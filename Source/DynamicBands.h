@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    Bandas dinâmicas: o ganho de uma banda peak passa a depender do nível da
+    entrada na própria banda, como em um compressor de uma banda só.
+
+    O detector filtra a entrada com um passa-banda na frequência e na qualidade
+    da banda e segue a envoltória de cada canal com um juce::dsp::BallisticsFilter.
+    O nível dos canais é ligado (vale o maior), para que a banda mude igual em
+    todos e a imagem estéreo não se mova.
+
+    O detector pode medir o próprio sinal ou o do barramento de sidechain. Roda em
+    float, na taxa do host e antes da sobreamostragem. O nível é lido e o ganho
+    recalculado a cada ponto da grade de recálculo dos coeficientes, que usa
+    posições absolutas: o resultado não depende do tamanho de bloco do host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadCascade.h"
+
+//==============================================================================
+// Redução máxima aplicada por uma banda dinâmica
+constexpr float maxDynamicRange = 24.f;
+
+// Curva de compressão com joelho duro: quanto a banda é reduzida, em dB, para um
+// nível de detecção 'levelDb'
+inline float getDynamicGainReduction(float levelDb, float thresholdDb, float ratio)
+{
+    jassert(ratio >= 1.f);
+
+    const auto over = levelDb - thresholdDb;
+    if (over <= 0.f)
+        return 0.f;
+
+    return juce::jmin(maxDynamicRange, over * (1.f - 1.f / juce::jmax(1.f, ratio)));
+}
+
+//==============================================================================
+class BandDetector
+{
+public:
+    // Aloca o estado e o buffer de trabalho de numChannels canais
+    void prepare(double newSampleRate, int numChannels, int maximumBlockSize)
+    {
+        sampleRate = newSampleRate;
+        numChannels = juce::jmax(1, numChannels);
+
+        envelope.prepare({ sampleRate, (juce::uint32)maximumBlockSize, (juce::uint32)numChannels });
+        envelope.setLevelCalculationType(juce::dsp::BallisticsFilterLevelCalculationType::peak);
+
+        bandPass.prepare((size_t)numChannels, (size_t)maximumBlockSize);
+        detection.setSize(numChannels, maximumBlockSize);
+
+        frequency = quality = 0.f;
+        attack = release = -1.f;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        envelope.reset();
+        bandPass.reset();
+    }
+
+    // Ajustes da banda; só recalculam o que mudou. Não alocam memória.
+    void setBand(float newFrequency, float newQuality) noexcept
+    {
+        if (newFrequency == frequency && newQuality == quality)
+            return;
+
+        frequency = newFrequency;
+        quality = newQuality;
+
+        bandPass.setCoefficients(makeBandPassCoefficients(sampleRate, juce::jmin((double)frequency, sampleRate * 0.49), quality));
+    }
+
+    void setTimes(float attackMs, float releaseMs) noexcept
+    {
+        if (attackMs != attack)
+            envelope.setAttackTime(attack = attackMs);
+
+        if (releaseMs != release)
+            envelope.setReleaseTime(release = releaseMs);
+    }
+
+    // Mede o bloco, sem alterá-lo, e devolve o nível ao fim dele em dB. O passa-banda
+    // usa a mesma cascata SIMD da cadeia principal, um canal por faixa do registrador.
+    template<typename SampleType>
+    float process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        const auto numChannels = juce::jmin(block.getNumChannels(), (size_t)detection.getNumChannels());
+        const auto numSamples = block.getNumSamples();
+
+        jassert(numSamples <= (size_t)detection.getNumSamples());
+
+        if (numChannels == 0 || numSamples == 0)
+            return juce::Decibels::gainToDecibels(0.f);
+
+        auto filtered = juce::dsp::AudioBlock<float>(detection).getSubsetChannelBlock(0, numChannels).getSubBlock(0, numSamples);
+
+        // O passa-banda roda no lugar: a entrada é copiada (e convertida para float)
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* input = block.getChannelPointer(channel);
+            auto* output = filtered.getChannelPointer(channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                output[i] = (float)input[i];
+        }
+
+        bandPass.process(filtered);
+
+        auto level = 0.f;
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* samples = filtered.getChannelPointer(channel);
+            auto value = 0.f;
+
+            for (size_t i = 0; i < numSamples; ++i)
+                value = envelope.processSample((int)channel, samples[i]);
+
+            level = juce::jmax(level, value);
+        }
+
+        return juce::Decibels::gainToDecibels(level);
+    }
+
+private:
+    MultichannelCascade<float> bandPass;
+    juce::dsp::BallisticsFilter<float> envelope;
+    juce::AudioBuffer<float> detection;
+
+    double sampleRate{ 44100.0 };
+    float frequency{ 0.f }, quality{ 0.f }, attack{ -1.f }, release{ -1.f };
+};
@@ -0,0 +1,620 @@
+/*
+  ==============================================================================
+
+    Modo de fase linear: um FIR com a mesma magnitude da cadeia IIR, aplicado
+    por convolução FFT particionada não uniforme (overlap-save).
+
+    O começo do kernel usa partições pequenas, calculadas na thread de áudio,
+    e define a latência; o resto usa partições grandes, calculadas por uma
+    thread de trabalho de tempo real durante o bloco seguinte. Assim o custo
+    por bloco de áudio é constante mesmo com kernels de 16k coeficientes, e a
+    thread de áudio nunca espera pela de trabalho.
+
+    O kernel é projetado fora da thread de áudio a partir da magnitude de
+    ChainCoefficients e entregue ao convolvedor por troca de buffers: a thread
+    de áudio nunca aloca nem espera pelo projeto, e cabeça e cauda fazem um
+    crossfade entre o kernel antigo e o novo. O espectro da entrada (a linha de atraso no
+    domínio da frequência) não depende do kernel, por isso a troca não perde
+    estado.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadCascade.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+// Resposta ao impulso de fase linear e comprimento 'length' (potência de 2), com
+// a magnitude de 'chain' e atraso de length / 2 amostras. A magnitude é amostrada
+// em length / 2 + 1 frequências e a resposta de fase zero resultante é centrada e
+// janelada com uma Blackman periódica. Cortes muito graves precisam de kernels
+// longos: a resolução em frequência é sampleRate / length.
+// Aloca memória; não deve ser chamada na thread de áudio.
+inline void makeLinearPhaseImpulse(const ChainCoefficients& chain, double sampleRate, int length, std::vector<float>& impulse)
+{
+    jassert(juce::isPowerOfTwo(length) && length >= 2);
+
+    juce::dsp::FFT fft(juce::roundToInt(std::log2((double)length)));
+    std::vector<float> data((size_t)length * 2, 0.f);
+
+    for (int k = 0; k <= length / 2; ++k)
+        data[(size_t)k * 2] = (float)chain.getMagnitudeForFrequency(k * sampleRate / length, sampleRate);
+
+    fft.performRealOnlyInverseTransform(data.data());
+
+    impulse.resize((size_t)length);
+    for (int n = 0; n < length; ++n)
+    {
+        const auto phase = juce::MathConstants<double>::twoPi * n / length;
+        const auto window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        impulse[(size_t)n] = (float)(data[(size_t)((n + length / 2) % length)] * window);
+    }
+}
+
+//==============================================================================
+// Uma etapa de convolução particionada uniforme: os espectros das partições de um
+// trecho do kernel (em dois buffers, para a troca) e, por canal, a linha de atraso
+// de espectros da entrada. Cada chamada de process() consome e produz
+// partitionSize amostras de um canal.
+class ConvolutionStage
+{
+public:
+    void prepare(int newPartitionSize, int maximumPartitions, size_t numChannels)
+    {
+        jassert(juce::isPowerOfTwo(newPartitionSize));
+
+        partitionSize = newPartitionSize;
+        numBins = partitionSize + 1;
+        maxPartitions = juce::jmax(1, maximumPartitions);
+
+        const auto fftOrder = juce::roundToInt(std::log2((double)partitionSize)) + 1;
+        fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+        designFft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+        for (auto& kernel : kernels)
+        {
+            kernel.re.assign((size_t)(maxPartitions * numBins), 0.f);
+            kernel.im.assign((size_t)(maxPartitions * numBins), 0.f);
+            kernel.numPartitions = 0;
+        }
+
+        channels.resize(numChannels);
+        for (auto& channel : channels)
+        {
+            channel.frame.assign((size_t)partitionSize * 2, 0.f);
+            channel.spectrumRe.assign((size_t)(maxPartitions * numBins), 0.f);
+            channel.spectrumIm.assign((size_t)(maxPartitions * numBins), 0.f);
+        }
+
+        scratch.assign((size_t)partitionSize * 4, 0.f);
+        designScratch.assign((size_t)partitionSize * 4, 0.f);
+        accumulatorRe.assign((size_t)numBins, 0.f);
+        accumulatorIm.assign((size_t)numBins, 0.f);
+        previousOutput.assign((size_t)partitionSize, 0.f);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channel : channels)
+        {
+            std::fill(channel.frame.begin(), channel.frame.end(), 0.f);
+            std::fill(channel.spectrumRe.begin(), channel.spectrumRe.end(), 0.f);
+            std::fill(channel.spectrumIm.begin(), channel.spectrumIm.end(), 0.f);
+        }
+
+        spectrumPosition = 0;
+    }
+
+    int getPartitionSize() const noexcept { return partitionSize; }
+    int getMaximumLength() const noexcept { return maxPartitions * partitionSize; }
+
+    // Transforma as partições de 'impulse' no buffer de kernel 'slot'. Chamado apenas
+    // pela thread de projeto, para o buffer que a thread de áudio não está usando.
+    void setKernel(int slot, const float* impulse, int length) noexcept
+    {
+        jassert(length <= getMaximumLength());
+
+        auto& kernel = kernels[(size_t)slot];
+        kernel.numPartitions = juce::jlimit(0, maxPartitions, (length + partitionSize - 1) / partitionSize);
+
+        for (int p = 0; p < kernel.numPartitions; ++p)
+        {
+            std::fill(designScratch.begin(), designScratch.end(), 0.f);
+
+            const auto offset = p * partitionSize;
+            const auto count = juce::jmin(partitionSize, length - offset);
+            std::copy(impulse + offset, impulse + offset + count, designScratch.begin());
+
+            designFft->performRealOnlyForwardTransform(designScratch.data(), true);
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                kernel.re[(size_t)(p * numBins + k)] = designScratch[(size_t)k * 2];
+                kernel.im[(size_t)(p * numBins + k)] = designScratch[(size_t)k * 2 + 1];
+            }
+        }
+    }
+
+    // Acrescenta partitionSize amostras de entrada do canal e escreve partitionSize
+    // amostras de saída. Com previousSlot >= 0 a saída faz um crossfade do kernel
+    // previousSlot para o kernel slot. Depois de todos os canais, chame advance().
+    void process(size_t channelIndex, const float* input, float* output, int slot, int previousSlot) noexcept
+    {
+        auto& channel = channels[channelIndex];
+
+        std::copy(input, input + partitionSize, channel.frame.begin() + partitionSize);
+        std::copy(channel.frame.begin(), channel.frame.end(), scratch.begin());
+        fft->performRealOnlyForwardTransform(scratch.data(), true);
+
+        const auto offset = (size_t)(spectrumPosition * numBins);
+        for (size_t k = 0; k < (size_t)numBins; ++k)
+        {
+            channel.spectrumRe[offset + k] = scratch[k * 2];
+            channel.spectrumIm[offset + k] = scratch[k * 2 + 1];
+        }
+
+        convolve(kernels[(size_t)slot], channel, output);
+
+        if (previousSlot >= 0)
+        {
+            convolve(kernels[(size_t)previousSlot], channel, previousOutput.data());
+
+            for (int i = 0; i < partitionSize; ++i)
+            {
+                const auto fade = (float)(i + 1) / (float)partitionSize;
+                output[i] = previousOutput[(size_t)i] + fade * (output[i] - previousOutput[(size_t)i]);
+            }
+        }
+
+        std::copy(channel.frame.begin() + partitionSize, channel.frame.end(), channel.frame.begin());
+    }
+
+    void advance() noexcept
+    {
+        spectrumPosition = (spectrumPosition + 1) % maxPartitions;
+    }
+
+private:
+    // Espectros das partições, como estrutura de arrays para vetorizar a multiplicação complexa
+    struct Kernel
+    {
+        std::vector<float> re, im;
+        int numPartitions{ 0 };
+    };
+
+    struct Channel
+    {
+        std::vector<float> frame;                   // partição anterior + partição atual
+        std::vector<float> spectrumRe, spectrumIm;  // linha de atraso de espectros da entrada
+    };
+
+    void convolve(const Kernel& kernel, const Channel& channel, float* output) noexcept
+    {
+        std::fill(accumulatorRe.begin(), accumulatorRe.end(), 0.f);
+        std::fill(accumulatorIm.begin(), accumulatorIm.end(), 0.f);
+
+        auto* yRe = accumulatorRe.data();
+        auto* yIm = accumulatorIm.data();
+
+        for (int p = 0; p < kernel.numPartitions; ++p)
+        {
+            const auto slot = (spectrumPosition - p + maxPartitions) % maxPartitions;
+            const auto* xRe = channel.spectrumRe.data() + slot * numBins;
+            const auto* xIm = channel.spectrumIm.data() + slot * numBins;
+            const auto* hRe = kernel.re.data() + p * numBins;
+            const auto* hIm = kernel.im.data() + p * numBins;
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                yRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+                yIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+            }
+        }
+
+        for (size_t k = 0; k < (size_t)numBins; ++k)
+        {
+            scratch[k * 2] = yRe[k];
+            scratch[k * 2 + 1] = yIm[k];
+        }
+
+        fft->performRealOnlyInverseTransform(scratch.data());
+
+        // Overlap-save: só a segunda metade do quadro é convolução linear válida
+        std::copy(scratch.begin() + partitionSize, scratch.begin() + 2 * partitionSize, output);
+    }
+
+    int partitionSize{ 0 }, numBins{ 0 }, maxPartitions{ 0 };
+    int spectrumPosition{ 0 };
+
+    std::unique_ptr<juce::dsp::FFT> fft, designFft;
+    std::array<Kernel, 2> kernels;
+    std::vector<Channel> channels;
+
+    // scratch é usado por quem chama process(); designScratch, por quem chama setKernel()
+    std::vector<float> scratch, designScratch, accumulatorRe, accumulatorIm, previousOutput;
+};
+
+//==============================================================================
+// Convolução particionada não uniforme de vários canais com o mesmo kernel.
+//
+// A cabeça (partições de headPartitionSize) roda na thread de áudio e define a
+// latência. A cauda (partições de tailPartitionSize) recebe um bloco completo de
+// entrada e tem um bloco inteiro para ser calculada pela thread de trabalho; por
+// isso começa em tailOffset, onde seu resultado só é necessário um bloco depois.
+//
+// Os blocos de cauda passam por dois pares de buffers de entrada e saída, e a
+// thread de áudio nunca espera pela de trabalho nem calcula a cauda ela mesma:
+// um bloco que não ficou pronto a tempo é descartado e a cauda falta na saída
+// durante aquele bloco. A entrega de um bloco é só um estado atômico, que a
+// thread de trabalho consulta; a de áudio não toma mutex nem sinaliza eventos.
+//
+// Um kernel novo entra primeiro na cauda, com um crossfade ao longo do bloco, e
+// a cabeça o adota no limite seguinte, quando a saída daquele bloco de cauda
+// começa; assim cabeça e cauda nunca somam kernels diferentes.
+class PartitionedConvolver
+{
+public:
+    static constexpr int headPartitionSize = 64;
+    static constexpr int tailPartitionSize = 1024;
+    static constexpr int tailOffset = 2 * tailPartitionSize - headPartitionSize;
+
+    static_assert(tailPartitionSize % headPartitionSize == 0, "os limites da cauda precisam coincidir com os da cabeça");
+
+    // Latência total de um kernel de fase linear de 'kernelLength' amostras
+    static constexpr int getLatencyInSamples(int kernelLength) { return kernelLength / 2 + headPartitionSize; }
+
+    ~PartitionedConvolver()
+    {
+        tailWorker.stopThread(1000);
+    }
+
+    void prepare(double sampleRate, size_t numChannels, int maximumKernelLength)
+    {
+        jassert(maximumKernelLength > 0);
+
+        tailWorker.stopThread(1000);
+
+        const auto tailLength = juce::jmax(0, maximumKernelLength - tailOffset);
+        head.prepare(headPartitionSize, tailOffset / headPartitionSize, numChannels);
+        tail.prepare(tailPartitionSize, (tailLength + tailPartitionSize - 1) / tailPartitionSize, numChannels);
+
+        const auto numSamples = (size_t)tailPartitionSize * numChannels;
+        headInput.assign((size_t)headPartitionSize * numChannels, 0.f);
+        headOutput.assign((size_t)headPartitionSize * numChannels, 0.f);
+        tailInput.assign(numSamples, 0.f);
+        tailOutput.assign(numSamples, 0.f);
+        numPreparedChannels = numChannels;
+
+        for (auto& job : jobs)
+        {
+            job.input.assign(numSamples, 0.f);
+            job.output.assign(numSamples, 0.f);
+            job.state.store(JobState::idle);
+        }
+
+        nextJob = 0;
+        tailWorker.nextJob = 0;
+
+        activeKernel.store(0);
+        tailKernel = 0;
+        kernelState.store(KernelState::free);
+        reset();
+
+        // A thread de trabalho tem um bloco de cauda inteiro para cada trabalho: roda
+        // com prioridade de tempo real, como a de áudio, e volta a entrar no workgroup
+        tailWorker.workgroupChanged.store(true);
+
+        if (!tailWorker.startRealtimeThread(juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(tailPartitionSize, sampleRate)))
+            tailWorker.startThread(juce::Thread::Priority::highest);
+    }
+
+    // Workgroup de áudio do host (macOS): a thread de trabalho entra nele, para
+    // que o sistema a escalone junto com a thread de áudio
+    void setAudioWorkgroup(const juce::AudioWorkgroup& newWorkgroup)
+    {
+        {
+            const juce::SpinLock::ScopedLockType lock(tailWorker.workgroupLock);
+            tailWorker.workgroup = newWorkgroup;
+        }
+
+        tailWorker.workgroupChanged.store(true);
+    }
+
+    // Limpa o estado e adota imediatamente, sem crossfade, um kernel que estiver
+    // esperando. Não aloca nem espera: blocos de cauda em andamento são descartados
+    // e a thread de trabalho limpa a cauda antes do próximo.
+    void reset() noexcept
+    {
+        ++generation;
+        submittedJob = -1;
+        clearTail = true;
+
+        if (kernelState.load(std::memory_order_acquire) == KernelState::ready)
+        {
+            tailKernel = 1 - activeKernel.load();
+            kernelState.store(KernelState::switching);
+        }
+
+        activeKernel.store(tailKernel);
+        releaseKernel();
+
+        head.reset();
+
+        for (auto* samples : { &headInput, &headOutput, &tailInput, &tailOutput })
+            std::fill(samples->begin(), samples->end(), 0.f);
+
+        headPosition = 0;
+        tailPosition = 0;
+    }
+
+    //==============================================================================
+    // Lado do projeto (uma única thread que não é a de áudio)
+
+    // true quando o kernel entregue antes já foi adotado pela cabeça e pela cauda
+    bool canSetKernel() const noexcept { return kernelState.load(std::memory_order_acquire) == KernelState::free; }
+
+    // Divide o kernel entre cabeça e cauda no buffer que a thread de áudio não está
+    // usando e o marca como pronto; a troca começa no próximo limite da cauda.
+    void setKernel(const float* impulse, int length) noexcept
+    {
+        jassert(canSetKernel());
+
+        const auto slot = 1 - activeKernel.load();
+        const auto headLength = juce::jmin(length, tailOffset);
+
+        head.setKernel(slot, impulse, headLength);
+        tail.setKernel(slot, impulse + headLength, juce::jmin(length - headLength, tail.getMaximumLength()));
+
+        kernelState.store(KernelState::ready, std::memory_order_release);
+    }
+
+    //==============================================================================
+    // Lado do áudio
+
+    template<typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept
+    {
+        const auto numChannels = juce::jmin((size_t)buffer.getNumChannels(), numPreparedChannels);
+
+        for (int done = 0; done < numSamples;)
+        {
+            const auto n = juce::jmin(numSamples - done, headPartitionSize - headPosition);
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer((int)ch, startSample + done);
+                auto* inHead = headInput.data() + ch * headPartitionSize + headPosition;
+                auto* inTail = tailInput.data() + ch * tailPartitionSize + tailPosition;
+                const auto* outHead = headOutput.data() + ch * headPartitionSize + headPosition;
+                const auto* outTail = tailOutput.data() + ch * tailPartitionSize + tailPosition;
+
+                for (int i = 0; i < n; ++i)
+                {
+                    inHead[i] = inTail[i] = static_cast<float>(data[i]);
+                    data[i] = static_cast<SampleType>(outHead[i] + outTail[i]);
+                }
+            }
+
+            done += n;
+            headPosition += n;
+            tailPosition += n;
+
+            if (headPosition == headPartitionSize)
+            {
+                auto previousKernel = -1;
+
+                if (tailPosition == tailPartitionSize)
+                {
+                    previousKernel = processTailBoundary(numChannels);
+                    tailPosition = 0;
+                }
+
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                    head.process(ch, headInput.data() + ch * headPartitionSize, headOutput.data() + ch * headPartitionSize,
+                                 activeKernel.load(), previousKernel);
+
+                head.advance();
+                headPosition = 0;
+
+                // O kernel anterior só pode ser sobrescrito pelo projeto depois do
+                // crossfade da cabeça e do último bloco de cauda que o usa
+                releaseKernel();
+            }
+        }
+    }
+
+private:
+    enum class KernelState { free, ready, switching };
+    enum class JobState { idle, pending, running, done };
+
+    // Um bloco de cauda: escrito pela thread de áudio em 'idle' ou 'done' e pela de
+    // trabalho em 'running'
+    struct TailJob
+    {
+        std::vector<float> input, output;
+        size_t numChannels{ 0 };
+        int kernel{ 0 }, previousKernel{ -1 };
+        uint32_t generation{ 0 };
+        bool clearTail{ false };
+        std::atomic<JobState> state{ JobState::idle };
+    };
+
+    // Recolhe o bloco de cauda entregue no limite anterior, avança a troca de kernel
+    // e entrega o bloco de entrada que acabou de ser completado. Devolve o kernel
+    // anterior, se a cabeça trocou agora, para o crossfade dela.
+    int processTailBoundary(size_t numChannels) noexcept
+    {
+        const auto ready = submittedJob >= 0 && jobs[(size_t)submittedJob].state.load(std::memory_order_acquire) == JobState::done
+                           && jobs[(size_t)submittedJob].generation == generation;
+
+        if (ready)
+            std::copy(jobs[(size_t)submittedJob].output.begin(), jobs[(size_t)submittedJob].output.end(), tailOutput.begin());
+        else
+            std::fill(tailOutput.begin(), tailOutput.end(), 0.f);
+
+        // A cauda já trocou no limite anterior: a cabeça a acompanha agora. Senão, um
+        // kernel pronto entra na cauda, com crossfade, e a cabeça espera um bloco.
+        auto previousKernel = -1, previousTailKernel = -1;
+
+        if (tailKernel != activeKernel.load())
+        {
+            previousKernel = activeKernel.load();
+            activeKernel.store(tailKernel);
+        }
+        else if (kernelState.load(std::memory_order_acquire) == KernelState::ready)
+        {
+            previousTailKernel = tailKernel;
+            tailKernel = 1 - tailKernel;
+            kernelState.store(KernelState::switching);
+        }
+
+        submitJob(numChannels, previousTailKernel);
+
+        return previousKernel;
+    }
+
+    // Entrega tailInput à thread de trabalho. Se ela ainda estiver no bloco que
+    // ocupa o buffer, este bloco é perdido e a cauda recomeça limpa no próximo.
+    void submitJob(size_t numChannels, int previousTailKernel) noexcept
+    {
+        auto& job = jobs[(size_t)nextJob];
+        const auto state = job.state.load(std::memory_order_acquire);
+
+        if (state == JobState::pending || state == JobState::running)
+        {
+            submittedJob = -1;
+            clearTail = true;
+            return;
+        }
+
+        std::copy(tailInput.begin(), tailInput.begin() + (std::ptrdiff_t)(numChannels * tailPartitionSize), job.input.begin());
+        job.numChannels = numChannels;
+        job.kernel = tailKernel;
+        job.previousKernel = previousTailKernel;
+        job.generation = generation;
+        job.clearTail = clearTail;
+        clearTail = false;
+
+        // Só o estado atômico: a thread de trabalho o consulta, sem sinal que tome um mutex
+        job.state.store(JobState::pending, std::memory_order_release);
+
+        submittedJob = nextJob;
+        nextJob = 1 - nextJob;
+    }
+
+    // Libera o buffer de kernel que saiu, se nenhum bloco de cauda ainda o usa
+    void releaseKernel() noexcept
+    {
+        if (kernelState.load(std::memory_order_acquire) != KernelState::switching || tailKernel != activeKernel.load())
+            return;
+
+        const auto previous = 1 - tailKernel;
+
+        for (const auto& job : jobs)
+        {
+            const auto state = job.state.load(std::memory_order_acquire);
+            if ((state == JobState::pending || state == JobState::running) && (job.kernel == previous || job.previousKernel == previous))
+                return;
+        }
+
+        kernelState.store(KernelState::free, std::memory_order_release);
+    }
+
+    // Um bloco da cauda, na thread de trabalho
+    void runJob(TailJob& job) noexcept
+    {
+        if (job.clearTail)
+            tail.reset();
+
+        for (size_t ch = 0; ch < job.numChannels; ++ch)
+            tail.process(ch, job.input.data() + ch * tailPartitionSize, job.output.data() + ch * tailPartitionSize,
+                         job.kernel, job.previousKernel);
+
+        tail.advance();
+        job.state.store(JobState::done, std::memory_order_release);
+    }
+
+    struct TailWorker : juce::Thread
+    {
+        static constexpr int pollInterval = 1;
+
+        explicit TailWorker(PartitionedConvolver& c) : juce::Thread("Linear Phase Tail"), convolver(c) {}
+
+        void run() override
+        {
+            juce::WorkgroupToken token;
+
+            while (!threadShouldExit())
+            {
+                if (workgroupChanged.exchange(false))
+                {
+                    juce::AudioWorkgroup newWorkgroup;
+
+                    {
+                        const juce::SpinLock::ScopedLockType lock(workgroupLock);
+                        newWorkgroup = workgroup;
+                    }
+
+                    token.reset();
+                    if (newWorkgroup)
+                        newWorkgroup.join(token);
+                }
+
+                // Os blocos são entregues alternando os dois buffers, e nessa ordem
+                // precisam passar pela linha de atraso da cauda
+                auto& job = convolver.jobs[(size_t)nextJob];
+                auto expected = JobState::pending;
+
+                if (job.state.compare_exchange_strong(expected, JobState::running, std::memory_order_acquire))
+                {
+                    convolver.runJob(job);
+                    nextJob = 1 - nextJob;
+                }
+                else
+                {
+                    // A thread de áudio não acorda a thread de trabalho (notify() toma
+                    // um mutex): ela consulta o estado a cada milissegundo, bem dentro
+                    // do prazo de um bloco de cauda (21 ms a 48 kHz, 5 ms a 192 kHz)
+                    sleep(pollInterval);
+                }
+            }
+        }
+
+        PartitionedConvolver& convolver;
+        int nextJob{ 0 };
+
+        juce::AudioWorkgroup workgroup;
+        juce::SpinLock workgroupLock;
+        std::atomic<bool> workgroupChanged{ false };
+    };
+
+    ConvolutionStage head, tail;
+
+    // activeKernel é o kernel da cabeça; tailKernel, o dos blocos de cauda entregues
+    // (thread de áudio). Diferem durante um bloco de cauda, em uma troca.
+    std::atomic<int> activeKernel{ 0 };
+    int tailKernel{ 0 };
+    std::atomic<KernelState> kernelState{ KernelState::free };
+
+    // Um canal após o outro, partitionSize amostras cada
+    std::vector<float> headInput, headOutput, tailInput, tailOutput;
+    size_t numPreparedChannels{ 0 };
+    int headPosition{ 0 }, tailPosition{ 0 };
+
+    // Usados apenas na thread de áudio: buffer do próximo bloco de cauda, o bloco
+    // entregue no último limite (-1 se nenhum) e a geração atual, que reset() avança
+    // para descartar os blocos em andamento
+    std::array<TailJob, 2> jobs;
+    int nextJob{ 0 }, submittedJob{ -1 };
+    uint32_t generation{ 0 };
+    bool clearTail{ true };
+
+    TailWorker tailWorker{ *this };
+};
@@ -0,0 +1,889 @@
+/*
+  ==============================================================================
+
+    Forma paralela da cadeia: a função de transferência da cascata inteira é
+    expandida em frações parciais,
+
+        H(z) = c0 + soma_k (beta0_k + beta1_k z^-1) / (1 + a1_k z^-1 + a2_k z^-2),
+
+    com um termo por seção da cadeia, sobre os mesmos polos dela. Todos os termos
+    recebem a mesma entrada e as saídas são somadas: não há a dependência de uma
+    seção para a seguinte que, na cascata, obriga cada amostra a esperar pela
+    anterior na mesma seção e pelas seções anteriores. Por isso os termos ocupam
+    as faixas do registrador SIMD (4 ou 8 por instrução em float) e cada canal é
+    processado sozinho: a amostra de entrada é replicada nas faixas e as saídas
+    dos termos são somadas no fim. Um canal mono usa o registrador inteiro.
+
+    A expansão é refeita só quando alguma seção ativa muda e serve a todos os
+    canais: uma para o primeiro canal (esquerdo ou mid) e outra para os demais,
+    que só diferem quando alguma seção afeta um lado só.
+
+    Os resíduos são calculados em double a partir dos polos de cada seção, sem
+    expandir polinômios, ao custo de O(n^2) por recálculo. A expansão é mal
+    condicionada com polos muito próximos, e os termos podem ser bem maiores que
+    a soma (um LowCut perto de DC se cancela quase todo com o termo direto). Por
+    isso cada expansão é conferida contra a resposta da cascata e, se o erro ou o
+    cancelamento forem grandes demais para a precisão de SampleType, a cadeia
+    passa a rodar em uma MultichannelCascade. A volta à forma paralela pede erros
+    bem abaixo dos limites, para não alternar a cada recálculo perto da fronteira.
+
+    Na troca, o motor que entra processa uma cópia da entrada junto com o que sai:
+    primeiro até o seu estado convergir (a cauda da cadeia, limitada) e depois
+    durante um crossfade entre as duas saídas. Enquanto isso o que sai mantém os
+    últimos coeficientes que aceitou. Fora das trocas a cascata fica parada e não
+    recebe coeficientes.
+
+    Cada termo usa a forma direta II, em que o estado depende só do denominador:
+    a saída é linear nos numeradores, e o crossfade entre duas expansões com os
+    mesmos polos é exato. Termos que entram partem do estado zero e os que saem
+    ficam na lista, com o numerador indo a zero, até o fim do crossfade. Quando
+    os polos de um termo que continua mudam, os numeradores saltam direto para
+    o novo valor, com o estado mantido, como na cascata.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadDesign.h"
+#include "BiquadCascade.h"
+#include <complex>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+template<typename SampleType>
+class ParallelCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr int maxSections = BiquadCascade<SampleType>::maxSections;
+    static constexpr size_t numLanes = Vec::size();
+
+    // Os termos de um canal, em registradores inteiros
+    static constexpr int maxGroups = (int)((maxSections + numLanes - 1) / numLanes);
+    static constexpr int maxTerms = maxGroups * (int)numLanes;
+
+    // Limites da conferência, em relação ao pico da resposta: erro da expansão;
+    // soma dos módulos dos termos vezes o épsilon de SampleType (o ruído de
+    // arredondamento da soma); e a mesma soma com cada termo pesado pela sua
+    // sensibilidade ao arredondamento dos coeficientes, que cresce perto de DC e
+    // de Nyquist. A cadeia deixa a forma paralela acima deles e só volta a ela
+    // abaixo de reentryMargin vezes eles.
+    static constexpr double maxExpansionError = 1.0e-6;
+    static constexpr double maxRoundingError = 1.0e-5;
+    static constexpr double maxQuantizationError = 1.0e-3;
+    static constexpr double reentryMargin = 0.25;
+
+    // Na troca de motor, o que entra roda sem ser ouvido até a cauda da cadeia cair
+    // warmupAttenuationDb, mas nunca mais que maxWarmupSamples amostras
+    static constexpr double warmupAttenuationDb = 80.0;
+    static constexpr int maxWarmupSamples = 8192;
+
+    // Aloca o estado de numChannels canais; com zero canais libera a memória
+    void prepare(size_t numChannels, size_t maximumBlockSize)
+    {
+        states.clear();
+        states.resize(numChannels);
+        cascade.prepare(numChannels, maximumBlockSize);
+
+        if (numChannels > 0)
+        {
+            incoming = juce::dsp::AudioBlock<SampleType>(incomingData, numChannels, maximumBlockSize);
+            incoming.clear();
+        }
+        else
+        {
+            incoming = {};
+            incomingData.free();
+        }
+
+        handoverWarmup = handoverRemaining = 0;
+
+        // O número de canais decide se há uma segunda expansão
+        slotsExpanded = false;
+
+        // Monta a tabela da conferência aqui, fora da thread de áudio
+        getCheckPoints();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& state : states)
+            state = {};
+
+        cascade.reset();
+
+        // Sem estado, o motor que sai não tem mais nada a entregar
+        handoverWarmup = handoverRemaining = 0;
+    }
+
+    // Os canais 0 e 1 passam a ser mid e side. O estado dos filtros não serve ao
+    // outro modo: chame reset() ao trocar.
+    void setMidSide(bool shouldUseMidSide) noexcept
+    {
+        midSide = shouldUseMidSide;
+        cascade.setMidSide(shouldUseMidSide);
+    }
+
+    // Expande a cadeia uma vez para todos os canais e monta as listas de termos.
+    // A cascata só recebe os coeficientes enquanto está em uso ou em uma troca.
+    // Se nenhuma seção ativa mudou desde a última chamada, não faz nada.
+    // Não aloca memória; pode ser chamado na thread de áudio entre dois blocos.
+    void setCoefficients(const ChainCoefficients& chain, int fadeLength = 0) noexcept
+    {
+        // Sem canais (o motor da precisão que o host não usa) não há o que atualizar
+        if (states.empty())
+            return;
+
+        fadeLength = juce::jmax(0, fadeLength);
+
+        // Com as mesmas seções a expansão, a escolha do motor e as listas de termos
+        // seriam as mesmas (a conferência só fica mais estrita com a margem menor
+        // da cascata): repetir só reiniciaria o crossfade em andamento
+        if (!setSlots(chain) && slotsExpanded)
+            return;
+
+        slotsExpanded = true;
+
+        const auto handingOver = isHandingOver();
+
+        if (useCascade || handingOver)
+            cascade.setCoefficients(chain, fadeLength);
+
+        const auto accurate = expandChain(useCascade ? reentryMargin : 1.0);
+
+        if (!useCascade)
+        {
+            if (accurate)
+            {
+                rebuildTerms(fadeLength);
+            }
+            else if (handingOver)
+            {
+                // A cascata ainda estava saindo, com o estado em dia
+                reverseHandover();
+            }
+            else
+            {
+                cascade.setCoefficients(chain, 0);
+                cascade.reset();
+                beginHandover(chain, fadeLength);
+            }
+        }
+        else if (accurate)
+        {
+            if (handingOver)
+            {
+                reverseHandover();
+                rebuildTerms(fadeLength);
+            }
+            else
+            {
+                rebuildTerms(0);
+
+                for (auto& state : states)
+                    state = {};
+
+                beginHandover(chain, fadeLength);
+            }
+        }
+    }
+
+    // Maior número de amostras aceito por process()
+    size_t getMaximumBlockSize() const noexcept { return cascade.getMaximumBlockSize(); }
+
+    void process(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) noexcept
+    {
+        process(juce::dsp::AudioBlock<SampleType>(buffer).getSubBlock((size_t)startSample, (size_t)numSamples));
+    }
+
+    void process(const juce::dsp::AudioBlock<SampleType>& audio) noexcept
+    {
+        const auto numChannels = juce::jmin(audio.getNumChannels(), states.size());
+        const auto numSamples = audio.getNumSamples();
+        const auto block = audio.getSubsetChannelBlock(0, numChannels);
+
+        jassert(numSamples <= getMaximumBlockSize());
+
+        if (!isHandingOver())
+        {
+            if (useCascade)
+                cascade.process(block);
+            else
+                processTerms(block);
+
+            return;
+        }
+
+        // O motor que entra processa uma cópia da entrada; o que sai, o próprio bloco
+        auto next = incoming.getSubBlock(0, numSamples).getSubsetChannelBlock(0, numChannels);
+        next.copyFrom(block);
+
+        if (useCascade)
+        {
+            cascade.process(next);
+            processTerms(block);
+        }
+        else
+        {
+            cascade.process(block);
+            processTerms(next);
+        }
+
+        // Durante o aquecimento a saída é só a do motor que sai; depois a do que
+        // entra ganha peso linearmente até substituí-la
+        const auto warmup = juce::jmin(numSamples, (size_t)handoverWarmup);
+        const auto numFading = juce::jmin(numSamples - warmup, (size_t)handoverRemaining);
+        const auto step = SampleType(1) / (SampleType)juce::jmax(1, handoverLength);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* output = block.getChannelPointer(channel);
+            const auto* input = next.getChannelPointer(channel);
+            auto remaining = handoverRemaining;
+            auto i = warmup;
+
+            for (; i < warmup + numFading; ++i)
+            {
+                const auto weight = SampleType(1) - (SampleType)--remaining * step;
+                output[i] += weight * (input[i] - output[i]);
+            }
+
+            for (; i < numSamples; ++i)
+                output[i] = input[i];
+        }
+
+        handoverWarmup -= (int)warmup;
+        handoverRemaining -= (int)numFading;
+    }
+
+private:
+    struct Terms;
+    struct ChannelState;
+    using Kernel = void (*)(const Terms&, ChannelState&, SampleType*, size_t) noexcept;
+
+    // Estado dos termos de um canal, na ordem da lista do seu grupo de canais
+    struct ChannelState
+    {
+        std::array<Vec, maxGroups> w1{}, w2{};
+    };
+
+    // Lista de termos de um grupo de canais, na ordem da cadeia, com o termo s na
+    // faixa s % numLanes do registrador s / numLanes. As faixas além de numTerms
+    // ficam com coeficientes zero e não contribuem para a saída.
+    struct Terms
+    {
+        std::array<Vec, maxGroups> beta0{}, beta1{}, target0{}, target1{}, dbeta0{}, dbeta1{}, a1{}, a2{};
+        std::array<int, maxTerms> slotOf{};
+        std::array<bool, maxTerms> leaving{};
+        int numTerms{ 0 }, numGroups{ 0 };
+
+        SampleType direct{ 1 }, directTarget{ 1 }, directStep{};
+        int fadeRemaining{ 0 };
+        Kernel kernel{ &processGroups<0> };
+    };
+
+    template<int NumGroups>
+    static void processGroups(const Terms& terms, ChannelState& state, SampleType* samples, size_t numSamples) noexcept
+    {
+        const auto c0 = terms.direct;
+
+        if constexpr (NumGroups == 0)
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+                samples[i] = c0 * samples[i];
+        }
+        else
+        {
+            // Cópias locais, como no kernel da cascata
+            std::array<Vec, NumGroups> c1, c2, d1, d2, z1, z2;
+            for (size_t g = 0; g < (size_t)NumGroups; ++g)
+            {
+                c1[g] = terms.beta0[g];
+                c2[g] = terms.beta1[g];
+                d1[g] = terms.a1[g];
+                d2[g] = terms.a2[g];
+                z1[g] = state.w1[g];
+                z2[g] = state.w2[g];
+            }
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto x = samples[i];
+                const auto input = Vec::expand(x);
+                auto sum = Vec::expand(SampleType());
+
+                for (size_t g = 0; g < (size_t)NumGroups; ++g)
+                {
+                    const auto w0 = input - d1[g] * z1[g] - d2[g] * z2[g];
+                    sum += c1[g] * w0 + c2[g] * z1[g];
+                    z2[g] = z1[g];
+                    z1[g] = w0;
+                }
+
+                samples[i] = c0 * x + sum.sum();
+            }
+
+            for (size_t g = 0; g < (size_t)NumGroups; ++g)
+            {
+                state.w1[g] = z1[g];
+                state.w2[g] = z2[g];
+            }
+        }
+    }
+
+    template<size_t... NumGroups>
+    static Kernel getKernel(int numGroups, std::index_sequence<NumGroups...>) noexcept
+    {
+        static constexpr Kernel kernels[] = { &processGroups<(int)NumGroups>... };
+        return kernels[numGroups];
+    }
+
+    // Durante o crossfade os numeradores e o termo direto avançam a cada amostra.
+    // Cada canal parte dos valores da lista, que só avança depois de todos eles.
+    static void processFade(const Terms& terms, ChannelState& state, SampleType* samples, size_t numSamples) noexcept
+    {
+        const auto numGroups = (size_t)terms.numGroups;
+        auto c0 = terms.direct;
+        auto c1 = terms.beta0, c2 = terms.beta1;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto x = samples[i];
+            const auto input = Vec::expand(x);
+            auto sum = Vec::expand(SampleType());
+
+            c0 += terms.directStep;
+
+            for (size_t g = 0; g < numGroups; ++g)
+            {
+                c1[g] += terms.dbeta0[g];
+                c2[g] += terms.dbeta1[g];
+
+                const auto w0 = input - terms.a1[g] * state.w1[g] - terms.a2[g] * state.w2[g];
+                sum += c1[g] * w0 + c2[g] * state.w1[g];
+                state.w2[g] = state.w1[g];
+                state.w1[g] = w0;
+            }
+
+            samples[i] = c0 * x + sum.sum();
+        }
+    }
+
+    // Termo s de um array de registradores
+    static SampleType getTerm(const std::array<Vec, maxGroups>& values, int s) noexcept
+    {
+        return SampleLanes<Vec>::get(values[(size_t)s / numLanes], (size_t)s % numLanes);
+    }
+
+    static void setTerm(std::array<Vec, maxGroups>& values, int s, SampleType value) noexcept
+    {
+        SampleLanes<Vec>::set(values[(size_t)s / numLanes], (size_t)s % numLanes, value);
+    }
+
+    // Grupo 0 é o primeiro canal (esquerdo ou mid); grupo 1, os demais
+    size_t getFirstChannel(size_t group) const noexcept { return juce::jmin(group, states.size()); }
+    size_t getEndChannel(size_t group) const noexcept { return group == 0 ? juce::jmin((size_t)1, states.size()) : states.size(); }
+
+    void processTerms(const juce::dsp::AudioBlock<SampleType>& audio) noexcept
+    {
+        const auto numChannels = audio.getNumChannels();
+        const auto numSamples = audio.getNumSamples();
+        const auto encoded = midSide && numChannels >= 2;
+
+        if (encoded)
+        {
+            auto* left = audio.getChannelPointer(0);
+            auto* right = audio.getChannelPointer(1);
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto mid = (left[i] + right[i]) * SampleType(0.5);
+                right[i] = (left[i] - right[i]) * SampleType(0.5);
+                left[i] = mid;
+            }
+        }
+
+        for (size_t group = 0; group < terms.size(); ++group)
+        {
+            auto& list = terms[group];
+            const auto firstChannel = getFirstChannel(group);
+            const auto endChannel = juce::jmin(getEndChannel(group), numChannels);
+            const auto numFading = juce::jmin(numSamples, (size_t)list.fadeRemaining);
+
+            if (numFading > 0)
+            {
+                for (auto channel = firstChannel; channel < endChannel; ++channel)
+                    processFade(list, states[channel], audio.getChannelPointer(channel), numFading);
+
+                advanceFade(group, (int)numFading);
+            }
+
+            for (auto channel = firstChannel; channel < endChannel; ++channel)
+                list.kernel(list, states[channel], audio.getChannelPointer(channel) + numFading, numSamples - numFading);
+        }
+
+        if (encoded)
+        {
+            auto* left = audio.getChannelPointer(0);
+            auto* right = audio.getChannelPointer(1);
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto mid = left[i];
+                left[i] = mid + right[i];
+                right[i] = mid - right[i];
+            }
+        }
+    }
+
+    bool isHandingOver() const noexcept { return handoverWarmup > 0 || handoverRemaining > 0; }
+
+    // O motor que entra parte do estado zero. Com fadeLength zero a troca é imediata.
+    void beginHandover(const ChainCoefficients& chain, int fadeLength) noexcept
+    {
+        useCascade = !useCascade;
+
+        const auto decay = std::ceil(chain.getDecaySamples(warmupAttenuationDb));
+        handoverWarmup = fadeLength > 0 ? (int)juce::jmin((double)maxWarmupSamples, decay) : 0;
+        handoverLength = handoverRemaining = fadeLength;
+    }
+
+    // Volta ao motor que estava saindo, que continua em dia, a partir da mistura atual
+    void reverseHandover() noexcept
+    {
+        useCascade = !useCascade;
+
+        if (handoverWarmup > 0)
+            handoverWarmup = handoverRemaining = 0;
+        else
+            handoverRemaining = handoverLength - handoverRemaining;
+    }
+
+    // Resultado da expansão para um grupo de canais, indexado pela posição na cadeia
+    struct Expansion
+    {
+        std::array<double, maxSections> beta0{}, beta1{};
+        double direct{ 1.0 };
+    };
+
+    // Cada posição fixa da cadeia guarda seus coeficientes e os canais que afeta
+    struct Slot
+    {
+        BiquadCoefficients coefficients;
+        bool active{ false };
+        StereoPlacement placement{ Placement_Both };
+    };
+
+    static bool isInGroup(const Slot& slot, size_t group) noexcept
+    {
+        return slot.active && affectsLane(slot.placement, group);
+    }
+
+    // Coeficientes de uma posição desligada não entram na expansão
+    static bool isSameSection(const Slot& slot, const BiquadCoefficients& coefficients, bool active, StereoPlacement placement) noexcept
+    {
+        if (slot.active != active)
+            return false;
+
+        if (!active)
+            return true;
+
+        const auto& c = slot.coefficients;
+        return slot.placement == placement
+            && c.b0 == coefficients.b0 && c.b1 == coefficients.b1 && c.b2 == coefficients.b2
+            && c.a1 == coefficients.a1 && c.a2 == coefficients.a2;
+    }
+
+    // Guarda as seções da cadeia; devolve se alguma seção ativa mudou
+    bool setSlots(const ChainCoefficients& chain) noexcept
+    {
+        int index = 0;
+        auto changed = false;
+        auto setSlot = [this, &index, &changed](const BiquadCoefficients& coefficients, bool active, StereoPlacement placement)
+            {
+                auto& slot = slots[(size_t)index++];
+                changed = changed || !isSameSection(slot, coefficients, active, placement);
+                slot.coefficients = coefficients;
+                slot.active = active;
+                slot.placement = placement;
+            };
+
+        for (int i = 0; i < maxCutFilterSections; ++i)
+            setSlot(chain.lowCut.sections[(size_t)i], i < chain.lowCut.numSections, chain.lowCutPlacement);
+
+        for (int i = 0; i < maxPeakBands; ++i)
+            setSlot(chain.peaks.bands[(size_t)i], chain.peaks.active[(size_t)i], chain.peaks.placement[(size_t)i]);
+
+        for (int i = 0; i < maxCutFilterSections; ++i)
+            setSlot(chain.highCut.sections[(size_t)i], i < chain.highCut.numSections, chain.highCutPlacement);
+
+        jassert(index == maxSections);
+        return changed;
+    }
+
+    // Expande a cadeia para o primeiro canal e, se alguma seção afetar só um lado,
+    // também para os demais. 'margin' escala os limites da conferência.
+    bool expandChain(double margin) noexcept
+    {
+        auto splitLanes = false;
+        for (const auto& slot : slots)
+            splitLanes = splitLanes || (slot.active && slot.placement != Placement_Both);
+
+        if (!expand(0, expansions[0], margin))
+            return false;
+
+        if (splitLanes && states.size() > 1)
+            return expand(1, expansions[1], margin);
+
+        expansions[1] = expansions[0];
+        return true;
+    }
+
+    bool expand(size_t group, Expansion& expansion, double margin) const noexcept
+    {
+        std::array<std::complex<double>, 2 * maxSections> poles;
+        std::array<int, maxSections> owners;
+        int numTerms = 0;
+
+        for (int index = 0; index < maxSections; ++index)
+        {
+            const auto& slot = slots[(size_t)index];
+            if (!isInGroup(slot, group))
+                continue;
+
+            const auto& c = slot.coefficients;
+            const auto discriminant = c.a1 * c.a1 - 4.0 * c.a2;
+
+            // Polo na origem ou duplo: a seção não tem a forma de dois polos simples
+            if (c.a2 == 0.0 || discriminant == 0.0)
+                return false;
+
+            const auto t = (size_t)numTerms;
+
+            if (discriminant < 0.0)
+            {
+                poles[2 * t] = { -0.5 * c.a1, 0.5 * std::sqrt(-discriminant) };
+                poles[2 * t + 1] = std::conj(poles[2 * t]);
+            }
+            else
+            {
+                // Raiz maior pela fórmula estável, a outra pelo produto a2
+                const auto root = -0.5 * (c.a1 + std::copysign(std::sqrt(discriminant), c.a1));
+                poles[2 * t] = root;
+                poles[2 * t + 1] = c.a2 / root;
+            }
+
+            owners[t] = index;
+            ++numTerms;
+        }
+
+        // Resíduo do polo p do termo t, de par q: o produto dos numeradores em z = p
+        // sobre o produto dos fatores (1 - p_k / p) dos demais polos. Os dois fatores
+        // de cada outra seção formam o seu denominador, 1 + a1 v + a2 v^2 em v = 1 / p,
+        // avaliado com coeficientes reais; só o par do próprio termo fica à parte.
+        auto residue = [&](int t, std::complex<double> p, std::complex<double> q)
+            {
+                const auto v = 1.0 / p;
+                const auto v2 = v * v;
+                std::complex<double> numerator = 1.0, denominator = 1.0 - q * v;
+
+                for (int k = 0; k < numTerms; ++k)
+                {
+                    const auto& c = slots[(size_t)owners[(size_t)k]].coefficients;
+                    numerator *= c.b0 + c.b1 * v + c.b2 * v2;
+
+                    if (k != t)
+                        denominator *= 1.0 + c.a1 * v + c.a2 * v2;
+                }
+
+                return numerator / denominator;
+            };
+
+        expansion.beta0.fill(0.0);
+        expansion.beta1.fill(0.0);
+
+        // O termo direto sai de H(z = infinito) = produto dos b0 = c0 + soma dos beta0
+        auto product = 1.0, sum = 0.0;
+
+        for (int t = 0; t < numTerms; ++t)
+        {
+            const auto p = poles[2 * (size_t)t];
+            const auto q = poles[2 * (size_t)t + 1];
+            const auto rp = residue(t, p, q);
+
+            // Os coeficientes são reais: o resíduo do polo conjugado é o conjugado
+            const auto rq = p.imag() != 0.0 ? std::conj(rp) : residue(t, q, p);
+
+            const auto index = (size_t)owners[(size_t)t];
+            expansion.beta0[index] = (rp + rq).real();
+            expansion.beta1[index] = -(rp * q + rq * p).real();
+
+            product *= slots[index].coefficients.b0;
+            sum += expansion.beta0[index];
+        }
+
+        expansion.direct = product - sum;
+
+        return isAccurate(group, expansion, margin);
+    }
+
+    // Frequências da conferência, espaçadas logaritmicamente de 1e-4 * Nyquist até
+    // Nyquist, como os valores de z^-1 correspondentes
+    static constexpr int numChecks = 32;
+
+    static const std::array<std::complex<double>, numChecks>& getCheckPoints() noexcept
+    {
+        static const auto points = []
+            {
+                std::array<std::complex<double>, numChecks> result;
+
+                for (int k = 0; k < numChecks; ++k)
+                {
+                    const auto w = juce::MathConstants<double>::pi * std::pow(1.0e-4, 1.0 - (double)k / (numChecks - 1));
+                    result[(size_t)k] = std::polar(1.0, -w);
+                }
+
+                return result;
+            }();
+
+        return points;
+    }
+
+    // Módulo sem o hypot() de std::abs, que evita estouros a um custo alto demais
+    // para a conferência: os valores aqui ficam longe dos limites de double
+    static double getMagnitude(const std::complex<double>& value) noexcept
+    {
+        return std::sqrt(std::norm(value));
+    }
+
+    // Confere a expansão contra a resposta da cascata em getCheckPoints()
+    bool isAccurate(size_t group, const Expansion& expansion, double margin) const noexcept
+    {
+        auto peak = 0.0, error = 0.0, spread = 0.0, sensitivity = 0.0;
+
+        for (const auto v : getCheckPoints())
+        {
+            const auto v2 = v * v;
+            std::complex<double> cascadeResponse = 1.0, parallelResponse = expansion.direct;
+            auto sum = std::abs(expansion.direct), weightedSum = sum;
+
+            for (int index = 0; index < maxSections; ++index)
+            {
+                const auto& slot = slots[(size_t)index];
+                if (!isInGroup(slot, group))
+                    continue;
+
+                const auto& c = slot.coefficients;
+                const auto denominator = 1.0 + c.a1 * v + c.a2 * v2;
+                const auto denominatorNorm = std::norm(denominator);
+                const auto inverse = std::conj(denominator) / denominatorNorm;
+                const auto term = (expansion.beta0[(size_t)index] + v * expansion.beta1[(size_t)index]) * inverse;
+
+                cascadeResponse *= (c.b0 + c.b1 * v + c.b2 * v2) * inverse;
+                parallelResponse += term;
+
+                const auto magnitude = getMagnitude(term);
+                sum += magnitude;
+
+                // Erro relativo do termo com a1 e a2 perturbados em um épsilon cada
+                weightedSum += magnitude * (1.0 + (std::abs(c.a1) + std::abs(c.a2)) / std::sqrt(denominatorNorm));
+            }
+
+            peak = juce::jmax(peak, getMagnitude(cascadeResponse));
+            error = juce::jmax(error, getMagnitude(parallelResponse - cascadeResponse));
+            spread = juce::jmax(spread, sum);
+            sensitivity = juce::jmax(sensitivity, weightedSum);
+        }
+
+        constexpr auto epsilon = std::numeric_limits<SampleType>::epsilon();
+
+        return error <= margin * maxExpansionError * peak
+            && spread * epsilon <= margin * maxRoundingError * peak
+            && sensitivity * epsilon <= margin * maxQuantizationError * peak;
+    }
+
+    void rebuildTerms(int newFadeLength) noexcept
+    {
+        for (size_t group = 0; group < terms.size(); ++group)
+            rebuildGroup(group, newFadeLength);
+    }
+
+    void rebuildGroup(size_t group, int newFadeLength) noexcept
+    {
+        auto& list = terms[group];
+        const auto& expansion = expansions[group];
+        const auto previous = list;
+
+        std::array<int, maxSections> previousTerm;
+        previousTerm.fill(-1);
+
+        for (int s = 0; s < previous.numTerms; ++s)
+            previousTerm[(size_t)previous.slotOf[(size_t)s]] = s;
+
+        // O crossfade só é exato se os termos que continuam mantêm os polos
+        auto canFade = newFadeLength > 0;
+        for (int index = 0; index < maxSections; ++index)
+        {
+            const auto s = previousTerm[(size_t)index];
+            const auto& slot = slots[(size_t)index];
+
+            if (s >= 0 && isInGroup(slot, group))
+                canFade = canFade && (SampleType)slot.coefficients.a1 == getTerm(previous.a1, s)
+                                  && (SampleType)slot.coefficients.a2 == getTerm(previous.a2, s);
+        }
+
+        const auto step = canFade ? SampleType(1) / (SampleType)newFadeLength : SampleType();
+
+        list = {};
+        list.direct = previous.direct;
+
+        std::array<int, maxTerms> source;
+
+        for (int index = 0; index < maxSections; ++index)
+        {
+            const auto s = previousTerm[(size_t)index];
+            const auto& slot = slots[(size_t)index];
+            const auto active = isInGroup(slot, group);
+
+            if (!active && !(s >= 0 && canFade))
+                continue;
+
+            const auto t = list.numTerms++;
+            list.slotOf[(size_t)t] = index;
+            list.leaving[(size_t)t] = !active;
+            source[(size_t)t] = s;
+
+            const auto target0 = active ? (SampleType)expansion.beta0[(size_t)index] : SampleType();
+            const auto target1 = active ? (SampleType)expansion.beta1[(size_t)index] : SampleType();
+
+            // Um termo que entra com crossfade parte do numerador zero
+            const auto beta0 = !canFade ? target0 : s >= 0 ? getTerm(previous.beta0, s) : SampleType();
+            const auto beta1 = !canFade ? target1 : s >= 0 ? getTerm(previous.beta1, s) : SampleType();
+
+            setTerm(list.beta0, t, beta0);
+            setTerm(list.beta1, t, beta1);
+            setTerm(list.target0, t, target0);
+            setTerm(list.target1, t, target1);
+            setTerm(list.dbeta0, t, (target0 - beta0) * step);
+            setTerm(list.dbeta1, t, (target1 - beta1) * step);
+
+            // Um termo que está saindo mantém os polos com que está rodando
+            setTerm(list.a1, t, active ? (SampleType)slot.coefficients.a1 : getTerm(previous.a1, s));
+            setTerm(list.a2, t, active ? (SampleType)slot.coefficients.a2 : getTerm(previous.a2, s));
+        }
+
+        list.directTarget = (SampleType)expansion.direct;
+
+        if (canFade)
+        {
+            list.directStep = (list.directTarget - list.direct) * step;
+        }
+        else
+        {
+            list.direct = list.directTarget;
+            list.directStep = SampleType();
+        }
+
+        list.fadeRemaining = canFade ? newFadeLength : 0;
+
+        finishList(group, previous, source);
+    }
+
+    // Avança a lista depois de numSamples amostras de crossfade em todos os canais
+    void advanceFade(size_t group, int numSamples) noexcept
+    {
+        auto& list = terms[group];
+        list.fadeRemaining -= numSamples;
+
+        if (list.fadeRemaining > 0)
+        {
+            const auto elapsed = Vec::expand((SampleType)numSamples);
+
+            for (size_t g = 0; g < (size_t)list.numGroups; ++g)
+            {
+                list.beta0[g] += list.dbeta0[g] * elapsed;
+                list.beta1[g] += list.dbeta1[g] * elapsed;
+            }
+
+            list.direct += list.directStep * (SampleType)numSamples;
+            return;
+        }
+
+        // Fim do crossfade: numeradores no alvo e termos que saíram fora da lista
+        const auto previous = list;
+        std::array<int, maxTerms> source;
+
+        list = {};
+
+        for (int s = 0; s < previous.numTerms; ++s)
+        {
+            if (previous.leaving[(size_t)s])
+                continue;
+
+            const auto t = list.numTerms++;
+            list.slotOf[(size_t)t] = previous.slotOf[(size_t)s];
+            source[(size_t)t] = s;
+
+            setTerm(list.beta0, t, getTerm(previous.target0, s));
+            setTerm(list.beta1, t, getTerm(previous.target1, s));
+            setTerm(list.target0, t, getTerm(previous.target0, s));
+            setTerm(list.target1, t, getTerm(previous.target1, s));
+            setTerm(list.a1, t, getTerm(previous.a1, s));
+            setTerm(list.a2, t, getTerm(previous.a2, s));
+        }
+
+        list.direct = list.directTarget = previous.directTarget;
+
+        finishList(group, previous, source);
+    }
+
+    // Escolhe o kernel da nova lista e leva o estado dos canais do grupo para as
+    // novas posições dos termos; source[t] é a posição anterior do termo t ou -1
+    void finishList(size_t group, const Terms& previous, const std::array<int, maxTerms>& source) noexcept
+    {
+        auto& list = terms[group];
+        list.numGroups = (list.numTerms + (int)numLanes - 1) / (int)numLanes;
+        list.kernel = list.numGroups == previous.numGroups ? previous.kernel
+                                                           : getKernel(list.numGroups, std::make_index_sequence<(size_t)maxGroups + 1>());
+
+        for (auto channel = getFirstChannel(group); channel < getEndChannel(group); ++channel)
+        {
+            auto& state = states[channel];
+            const auto previousState = state;
+            state = {};
+
+            for (int t = 0; t < list.numTerms; ++t)
+            {
+                const auto s = source[(size_t)t];
+                if (s < 0)
+                    continue;
+
+                setTerm(state.w1, t, getTerm(previousState.w1, s));
+                setTerm(state.w2, t, getTerm(previousState.w2, s));
+            }
+        }
+    }
+
+    std::array<Slot, maxSections> slots;
+    bool slotsExpanded{ false };
+    std::array<Expansion, 2> expansions;
+    std::array<Terms, 2> terms;
+    std::vector<ChannelState> states;
+    bool midSide{ false };
+
+    // Reserva para expansões recusadas
+    MultichannelCascade<SampleType> cascade;
+    bool useCascade{ false };
+
+    // Troca entre os motores em andamento: useCascade já indica o que entra
+    int handoverWarmup{ 0 }, handoverRemaining{ 0 }, handoverLength{ 0 };
+
+    // Cópia da entrada para o motor que entra durante uma troca
+    juce::HeapBlock<char> incomingData;
+    juce::dsp::AudioBlock<SampleType> incoming;
+};
@@ -361,16 +361,11 @@ void ResponseCurveComponent::timerCallback()
 
 void ResponseCurveComponent::updateChain() 
 {
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
-    auto sampleRate = audioProcessor.getSampleRate();
-    auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, sampleRate);
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, sampleRate);
+    auto chainSettings = audioProcessor.getChainSettingsSnapshot();
+    auto sampleRate = audioProcessor.getFilterSampleRate();
 
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+    // Os mesmos coeficientes que o processador usa, sem filtros nem bypass
+    chainCoefficients = makeChainCoefficients(chainSettings, sampleRate);
 }
 
 void ResponseCurveComponent::paint(juce::Graphics& g)
@@ -381,39 +376,16 @@ void ResponseCurveComponent::paint(juce::Graphics& g)
     auto responseArea = getRenderArea();
 
     auto w = responseArea.getWidth();
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
 
-    auto sampleRate = audioProcessor.getSampleRate();
+    // Com sobreamostragem a cadeia  projetada em uma taxa maior
+    auto sampleRate = audioProcessor.getFilterSampleRate();
     std::vector<double> mags;
 
     mags.resize(w);
     for (int i = 0; i < w; ++i)
     {
-        double mag = 1.f;
         auto freq = juce::mapToLog10(double(i) / double(w), 20.0, 20000.0);
-
-        if (!monoChain.isBypassed<ChainPositions::Peak>())
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-        if (!lowcut.isBypassed<0>())
-            mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowcut.isBypassed<1>())
-            mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowcut.isBypassed<2>())
-            mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowcut.isBypassed<3>())
-            mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-        if (!highcut.isBypassed<0>())
-            mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highcut.isBypassed<1>())
-            mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highcut.isBypassed<2>())
-            mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highcut.isBypassed<3>())
-            mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+        auto mag = chainCoefficients.getMagnitudeForFrequency(freq, sampleRate);
 
         mags[i] = juce::Decibels::gainToDecibels(mag);
     }
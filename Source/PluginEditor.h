@@ -289,21 +289,7 @@ struct ResponseCurveComponent : juce::Component, juce::AudioProcessorParameter::
 private:
     EqualizadorAudioProcessor& audioProcessor;
     juce::Atomic<bool> parametersChanged{ false };
-    juce::dsp::ProcessorChain<
-        juce::dsp::ProcessorChain<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>
-        >,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::ProcessorChain<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Filter<float>
-        >
-    > monoChain;
+    ChainCoefficients chainCoefficients;
 
     void updateChain();
 
@@ -16,17 +16,43 @@ EqualizadorAudioProcessor::EqualizadorAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        )
 #endif
 {
+    // Cada mudança de parâmetro publica um novo snapshot dos ajustes da cadeia
+    for (auto* param : getParameters())
+        if (auto* rangedParam = dynamic_cast<juce::RangedAudioParameter*>(param))
+            apvts.addParameterListener(rangedParam->paramID, this);
 
+    publishChainSettings();
 }
 
 EqualizadorAudioProcessor::~EqualizadorAudioProcessor()
 {
+    backgroundThread.stopThread(1000);
+
+    for (auto* param : getParameters())
+        if (auto* rangedParam = dynamic_cast<juce::RangedAudioParameter*>(param))
+            apvts.removeParameterListener(rangedParam->paramID, this);
+}
+
+void EqualizadorAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+
+    // Pode ser chamado de qualquer thread (inclusive a de áudio, durante automação),
+    // por isso só publica os ajustes; o projeto dos filtros fica para updateFilters(),
+    // que compara o snapshot com os ajustes aplicados para saber o que mudou.
+    publishChainSettings();
+}
+
+void EqualizadorAudioProcessor::publishChainSettings()
+{
+    chainSettingsSnapshot.publish([this] { return chainParameters.load(); });
 }
 
 //==============================================================================
@@ -64,7 +90,7 @@ bool EqualizadorAudioProcessor::isMidiEffect() const
 
 double EqualizadorAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.load();
 }
 
 int EqualizadorAudioProcessor::getNumPrograms()
@@ -91,53 +117,425 @@ void EqualizadorAudioProcessor::changeProgramName (int index, const juce::String
 {
 }
 
-void /*EqualizadorAudioProcessor::*/updateCoefficients(juce::dsp::IIR::Filter<float>::CoefficientsPtr& old, const juce::dsp::IIR::Filter<float>::CoefficientsPtr& replacements)
+void EqualizadorAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) 
 {
-    *old = *replacements;
+    // No modo Linked o corte vale para os dois canais
+    const auto placement = activeStereoMode == StereoMode::Stereo_Linked ? StereoPlacement::Placement_Both : chainSettings.lowCutPlacement;
+
+    if (activeFilterEngine == FilterEngine::Engine_Svf)
+    {
+        svfChainCoefficients.lowCut = makeSvfLowCutCoefficients(chainSettings, filterSampleRate.load());
+        svfChainCoefficients.lowCutPlacement = placement;
+    }
+    else
+    {
+        chainCoefficients.lowCut = makeLowCutCoefficients(chainSettings, filterSampleRate.load());
+        chainCoefficients.lowCutPlacement = placement;
+    }
 }
 
-void EqualizadorAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) 
+void EqualizadorAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+{
+    const auto placement = activeStereoMode == StereoMode::Stereo_Linked ? StereoPlacement::Placement_Both : chainSettings.highCutPlacement;
+
+    if (activeFilterEngine == FilterEngine::Engine_Svf)
+    {
+        svfChainCoefficients.highCut = makeSvfHighCutCoefficients(chainSettings, filterSampleRate.load());
+        svfChainCoefficients.highCutPlacement = placement;
+    }
+    else
+    {
+        chainCoefficients.highCut = makeHighCutCoefficients(chainSettings, filterSampleRate.load());
+        chainCoefficients.highCutPlacement = placement;
+    }
+}
+
+void EqualizadorAudioProcessor::updateFilters() 
 {
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+    auto dirty = dirtyFilters.exchange(0);
+    if (dirty == 0 && chainSettingsSnapshot.getVersion() == appliedChainSettingsVersion)
+        return;
+
+    ChainSettings chainSettings;
+    uint32_t version;
+    if (!chainSettingsSnapshot.tryRead(chainSettings, version))
+    {
+        // Uma escrita está em andamento: tenta de novo no próximo bloco
+        dirtyFilters.fetch_or(dirty);
+        return;
+    }
+
+    // Só os ajustes que o host mudou substituem os alvos; os demais mantêm o
+    // valor que receberam de eventos agendados
+    auto merge = [](auto& target, auto previous, auto next)
+        {
+            if (previous != next)
+                target = next;
+        };
+
+    for (size_t band = 0; band < (size_t)maxPeakBands; ++band)
+    {
+        auto& target = targetChainSettings.peakBands[band];
+        const auto& previous = hostChainSettings.peakBands[band];
+        const auto& next = chainSettings.peakBands[band];
+
+        merge(target.freq, previous.freq, next.freq);
+        merge(target.gain, previous.gain, next.gain);
+        merge(target.quality, previous.quality, next.quality);
+        merge(target.active, previous.active, next.active);
+        merge(target.dynamic, previous.dynamic, next.dynamic);
+        merge(target.threshold, previous.threshold, next.threshold);
+        merge(target.ratio, previous.ratio, next.ratio);
+        merge(target.attack, previous.attack, next.attack);
+        merge(target.release, previous.release, next.release);
+        merge(target.sidechain, previous.sidechain, next.sidechain);
+        merge(target.placement, previous.placement, next.placement);
+    }
 
-    auto& leftLowCut = leftChannelChain.get<ChainPositions::LowCut>();
-    auto& rightLowCut = rightChannelChain.get<ChainPositions::LowCut>();
+    merge(targetChainSettings.lowCutFreq, hostChainSettings.lowCutFreq, chainSettings.lowCutFreq);
+    merge(targetChainSettings.highCutFreq, hostChainSettings.highCutFreq, chainSettings.highCutFreq);
+    merge(targetChainSettings.lowCutSlope, hostChainSettings.lowCutSlope, chainSettings.lowCutSlope);
+    merge(targetChainSettings.highCutSlope, hostChainSettings.highCutSlope, chainSettings.highCutSlope);
+    merge(targetChainSettings.lowCutFamily, hostChainSettings.lowCutFamily, chainSettings.lowCutFamily);
+    merge(targetChainSettings.highCutFamily, hostChainSettings.highCutFamily, chainSettings.highCutFamily);
+    merge(targetChainSettings.filterEngine, hostChainSettings.filterEngine, chainSettings.filterEngine);
+    merge(targetChainSettings.designMethod, hostChainSettings.designMethod, chainSettings.designMethod);
+    merge(targetChainSettings.stereoMode, hostChainSettings.stereoMode, chainSettings.stereoMode);
+    hostChainSettings = chainSettings;
+    linearPhaseSettings.publish([this] { return targetChainSettings; });
 
-    updateCutFilter(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
+    // Os valores contínuos viram alvos da suavização e são aplicados na grade;
+    // só a mudança de inclinação precisa recalcular os filtros agora
+    dirty |= chainSettingsSmoother.setTargetValue(targetChainSettings);
+    appliedChainSettingsVersion = version;
+
+    if (dirty != 0)
+        designFilters(dirty, activeCoefficientUpdateInterval);
 }
 
-void EqualizadorAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+void EqualizadorAudioProcessor::advanceSmoothing(int numSamples)
+{
+    auto changed = chainSettingsSmoother.skip(numSamples) | updateDynamicGains();
+    if (changed != 0)
+        designFilters(changed, numSamples);
+}
+
+void EqualizadorAudioProcessor::applyParameterEvents(juce::int64 gridPosition)
+{
+    // Um evento vale no ponto da grade mais próximo dele: neste, se estiver antes
+    // do meio do intervalo seguinte
+    const auto end = gridPosition + activeCoefficientUpdateInterval - activeCoefficientUpdateInterval / 2;
+
+    ParameterEvent event;
+    bool changed = false;
+
+    while (parameterEvents.peek(event) && event.samplePosition < end)
+    {
+        // Eventos atrasados (de pontos já passados) valem a partir de agora
+        setChainParameter(targetChainSettings, event);
+        parameterEvents.pop();
+        changed = true;
+    }
+
+    // Como em updateFilters(): só o que não passa pela suavização é recalculado aqui
+    if (changed)
+    {
+        linearPhaseSettings.publish([this] { return targetChainSettings; });
+
+        auto dirty = chainSettingsSmoother.setTargetValue(targetChainSettings);
+        if (dirty != 0)
+            designFilters(dirty, activeCoefficientUpdateInterval);
+    }
+}
+
+void EqualizadorAudioProcessor::designFilters(int chainPositions, int rampLength)
 {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());;
+    const auto& chainSettings = chainSettingsSmoother.getCurrentValue();
+
+    // O estado de um motor não serve ao outro, nem o de um modo estéreo ao outro (as
+    // faixas passam a guardar mid/side em vez de esquerdo/direito): o novo começa do
+    // zero, já nos valores atuais
+    const auto stereoMode = getStereoMode(chainSettings);
 
-    auto& leftHighCut = leftChannelChain.get<ChainPositions::HighCut>();
-    auto& rightHighCut = rightChannelChain.get<ChainPositions::HighCut>();
+    if (chainSettings.filterEngine != activeFilterEngine || stereoMode != activeStereoMode)
+    {
+        activeFilterEngine = chainSettings.filterEngine;
+        setStereoMode(stereoMode);
+
+        chainPositions = allFiltersDirty;
+        rampLength = 0;
+    }
+
+    if (chainPositions & (1 << ChainPositions::LowCut))
+        updateLowCutFilters(chainSettings);
+
+    if (chainPositions & allPeakBandBits)
+        for (int band = 0; band < maxPeakBands; ++band)
+            if (chainPositions & getPeakBandBit(band))
+                updatePeakFilter(chainSettings, band);
+
+    if (chainPositions & (1 << ChainPositions::HighCut))
+        updateHighCutFilters(chainSettings);
+
+    // A rampa é medida em amostras da taxa em que a cadeia roda. Nos biquads ela só
+    // vale para o crossfade das seções que voltam à cascata.
+    const auto oversampledRampLength = rampLength << activeOversamplingOrder;
+
+    if (activeFilterEngine == FilterEngine::Engine_Svf)
+    {
+        floatSvfCascade.setCoefficients(svfChainCoefficients, oversampledRampLength);
+        doubleSvfCascade.setCoefficients(svfChainCoefficients, oversampledRampLength);
+    }
+    else if (activeFilterEngine == FilterEngine::Engine_Parallel)
+    {
+        floatParallelCascade.setCoefficients(chainCoefficients, oversampledRampLength);
+        doubleParallelCascade.setCoefficients(chainCoefficients, oversampledRampLength);
+    }
+    else
+    {
+        floatCascade.setCoefficients(chainCoefficients, oversampledRampLength);
+        doubleCascade.setCoefficients(chainCoefficients, oversampledRampLength);
+    }
 
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    iirTailDirty = true;
 }
 
-void EqualizadorAudioProcessor::updateFilters() 
+void EqualizadorAudioProcessor::updateTailLength()
 {
-    auto chainSettings = getChainSettings(apvts);
+    if (iirTailDirty)
+    {
+        iirTailDirty = false;
+        iirTailSamples = activeFilterEngine == FilterEngine::Engine_Svf ? svfChainCoefficients.getDecaySamples(-silenceThresholdDb)
+                                                                         : chainCoefficients.getDecaySamples(-silenceThresholdDb);
+    }
+
+    auto samples = 0.0;
+
+    if (linearPhaseActive)
+    {
+        // O kernel inteiro, depois da partição inicial
+        const auto length = getLinearPhaseLength();
+        samples = PartitionedConvolver::getLatencyInSamples(length) + length / 2;
+    }
+    else
+    {
+        samples = iirTailSamples / (1 << activeOversamplingOrder);
 
-    updateLowCutFilters(chainSettings);
-    updatePeakFilter(chainSettings);
-    updateHighCutFilters(chainSettings);
+        // Os filtros de meia banda também guardam estado: a latência de ida e volta
+        // conta duas vezes
+        if (activeOversamplingOrder > 0)
+            samples += 2 * oversamplingLatencies[(size_t)(activeOversamplingOrder - 1)][(size_t)activeOversamplingFilter];
+    }
+
+    tailSamples = samples < 1.0e15 ? (juce::int64)std::ceil(samples) : std::numeric_limits<juce::int64>::max();
+    tailLengthSeconds.store(samples / getSampleRate());
 }
 
-juce::dsp::IIR::Filter<float>::CoefficientsPtr makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
+template<typename SampleType>
+bool EqualizadorAudioProcessor::isSilent(const juce::AudioBuffer<SampleType>& buffer)
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, juce::Decibels::decibelsToGain(chainSettings.peakGain));
+    const auto threshold = (SampleType)juce::Decibels::decibelsToGain(silenceThresholdDb);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        if (buffer.getMagnitude(channel, 0, buffer.getNumSamples()) > threshold)
+            return false;
+
+    return true;
 }
 
-void EqualizadorAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+template<typename SampleType>
+void EqualizadorAudioProcessor::enterSleep()
 {
+    // A cauda já decaiu: zerar o estado não muda a saída
+    sleeping = true;
+
+    getCascade<SampleType>().reset();
+    getSvfCascade<SampleType>().reset();
+    getParallelCascade<SampleType>().reset();
+    linearPhaseConvolver.reset();
 
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
-    updateCoefficients(leftChannelChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChannelChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    if (activeOversamplingOrder > 0)
+        getOversamplers<SampleType>()[(size_t)(activeOversamplingOrder - 1)][(size_t)activeOversamplingFilter]->reset();
+}
+
+void EqualizadorAudioProcessor::leaveSleep()
+{
+    // As rampas do motor de variáveis de estado ficaram paradas durante a espera;
+    // com o estado zerado, os filtros podem saltar direto para os valores atuais
+    sleeping = false;
+    designFilters(allFiltersDirty, 0);
+}
+
+template<typename SampleType>
+void EqualizadorAudioProcessor::measureDynamicBands(const juce::dsp::AudioBlock<SampleType>& block, const juce::dsp::AudioBlock<SampleType>& sidechain)
+{
+    const auto hasSidechain = sidechain.getNumChannels() > 0;
+    const auto& chainSettings = chainSettingsSmoother.getCurrentValue();
+
+    for (int band = 0; band < maxPeakBands; ++band)
+    {
+        const auto& settings = chainSettings.peakBands[(size_t)band];
+        const auto bit = 1 << band;
+
+        // Banda estática (ou desligada): o detector recomeça do zero se ela voltar a
+        // ser dinâmica
+        if (!settings.active || !settings.dynamic)
+        {
+            detectingBands &= ~bit;
+            continue;
+        }
+
+        auto& detector = bandDetectors[(size_t)band];
+        const auto useSidechain = settings.sidechain && hasSidechain;
+
+        // O estado do passa-banda e da envoltória não serve a outro sinal
+        if ((detectingBands & bit) == 0 || ((sidechainBands & bit) != 0) != useSidechain)
+        {
+            detector.reset();
+            detectingBands |= bit;
+            sidechainBands = useSidechain ? (sidechainBands | bit) : (sidechainBands & ~bit);
+        }
+
+        detector.setBand(settings.freq, settings.quality);
+        detector.setTimes(settings.attack, settings.release);
+
+        dynamicLevels[(size_t)band] = detector.process(useSidechain ? sidechain : block);
+    }
+}
+
+int EqualizadorAudioProcessor::updateDynamicGains()
+{
+    const auto& chainSettings = chainSettingsSmoother.getCurrentValue();
+    int changed = 0;
+
+    for (int band = 0; band < maxPeakBands; ++band)
+    {
+        const auto& settings = chainSettings.peakBands[(size_t)band];
+        auto& gain = dynamicGains[(size_t)band];
+
+        // Bandas que não estão medindo voltam ao ganho do parâmetro
+        auto newGain = 0.f;
+        if ((detectingBands & (1 << band)) != 0)
+            newGain = -getDynamicGainReduction(dynamicLevels[(size_t)band], settings.threshold, settings.ratio);
+
+        if (newGain != gain)
+        {
+            gain = newGain;
+            changed |= getPeakBandBit(band);
+        }
+    }
+
+    return changed;
+}
+
+void EqualizadorAudioProcessor::updateLatency()
+{
+    // A sobreamostragem só envolve a cadeia IIR; o modo de fase linear roda na taxa do host
+    const auto order = getRequestedOversamplingOrder();
+    auto latency = 0;
+
+    if (isLinearPhaseEnabled())
+        latency = PartitionedConvolver::getLatencyInSamples(getLinearPhaseLength());
+    else if (order > 0)
+        latency = oversamplingLatencies[(size_t)(order - 1)][(size_t)getRequestedOversamplingFilter()];
+
+    if (reportedLatency.exchange(latency) != latency)
+        triggerAsyncUpdate();
+}
+
+void EqualizadorAudioProcessor::updateLinearPhaseKernel()
+{
+    const auto length = getLinearPhaseLength();
+
+    if (!isLinearPhaseEnabled() || !linearPhaseConvolver.canSetKernel())
+        return;
+
+    ChainSettings chainSettings;
+    uint32_t version;
+    if (!linearPhaseSettings.tryRead(chainSettings, version))
+        return;
+
+    if (version == designedLinearPhaseVersion && length == designedLinearPhaseLength)
+        return;
+
+    const auto chain = makeChainCoefficients(chainSettings, linearPhaseSampleRate);
+    makeLinearPhaseImpulse(chain, linearPhaseSampleRate, length, linearPhaseImpulse);
+    linearPhaseConvolver.setKernel(linearPhaseImpulse.data(), length);
+
+    designedLinearPhaseVersion = version;
+    designedLinearPhaseLength = length;
+}
+
+void EqualizadorAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(reportedLatency.load());
+}
+
+void EqualizadorAudioProcessor::setCoefficientUpdateInterval(int numSamples)
+{
+    jassert(numSamples > 0);
+    coefficientUpdateInterval.store(juce::jmax(1, numSamples));
+}
+
+void EqualizadorAudioProcessor::setSmoothingTime(double seconds)
+{
+    jassert(seconds >= 0.0);
+    smoothingTime.store(juce::jmax(0.0, seconds));
+}
+
+void EqualizadorAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings, int band)
+{
+    // Bandas dinâmicas somam a redução medida pelo detector ao ganho do parâmetro
+    auto settings = chainSettings.peakBands[(size_t)band];
+    settings.gain += dynamicGains[(size_t)band];
+
+    // Banda desligada ou neutra: sai da cascata e não é projetada
+    const auto active = isPeakBandAudible(settings);
+
+    // No modo Linked toda banda vale para os dois canais
+    const auto placement = activeStereoMode == StereoMode::Stereo_Linked ? StereoPlacement::Placement_Both : settings.placement;
+
+    if (activeFilterEngine == FilterEngine::Engine_Svf)
+    {
+        svfChainCoefficients.peaks.active[(size_t)band] = active;
+        svfChainCoefficients.peaks.placement[(size_t)band] = placement;
+        if (active)
+            svfChainCoefficients.peaks.bands[(size_t)band] = makeSvfPeakCoefficients(settings, chainSettings.designMethod, filterSampleRate.load());
+    }
+    else
+    {
+        chainCoefficients.peaks.active[(size_t)band] = active;
+        chainCoefficients.peaks.placement[(size_t)band] = placement;
+        if (active)
+            chainCoefficients.peaks.bands[(size_t)band] = makePeakCoefficients(settings, chainSettings.designMethod, filterSampleRate.load());
+    }
+}
+
+StereoMode EqualizadorAudioProcessor::getStereoMode(const ChainSettings& chainSettings) const
+{
+    return numMainChannels == 2 ? chainSettings.stereoMode : StereoMode::Stereo_Linked;
+}
+
+void EqualizadorAudioProcessor::setStereoMode(StereoMode stereoMode)
+{
+    activeStereoMode = stereoMode;
+
+    // M/S é codificado e decodificado pela própria cascata, ao intercalar os canais
+    const auto midSide = stereoMode == StereoMode::Stereo_MidSide;
+
+    floatCascade.reset();
+    doubleCascade.reset();
+    floatSvfCascade.reset();
+    doubleSvfCascade.reset();
+    floatParallelCascade.reset();
+    doubleParallelCascade.reset();
+
+    floatCascade.setMidSide(midSide);
+    doubleCascade.setMidSide(midSide);
+    floatSvfCascade.setMidSide(midSide);
+    doubleSvfCascade.setMidSide(midSide);
+    floatParallelCascade.setMidSide(midSide);
+    doubleParallelCascade.setMidSide(midSide);
 }
 
 //==============================================================================
@@ -148,10 +546,84 @@ void EqualizadorAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
 
-    leftChannelChain.prepare(spec);
-    rightChannelChain.prepare(spec);
+    // Um estado de filtro por canal, em grupos do tamanho de um registrador SIMD:
+    // mono, estéreo, 5.1, 7.1.4... Só a precisão em uso recebe memória, mas os
+    // motores são todos preparados para que a troca não precise alocar.
+    // Só o barramento principal passa pela cadeia; o sidechain alimenta apenas os detectores.
+    const auto numChannels = (size_t)juce::jmax(getMainBusNumInputChannels(), getMainBusNumOutputChannels());
+    const auto numSidechainChannels = getBusCount(true) > 1 ? getChannelCountOfBus(true, 1) : 0;
+    const auto useDouble = isUsingDoublePrecision();
 
-    updateFilters();
+    // A cadeia IIR pode rodar sobreamostrada: os blocos chegam a maxOversamplingFactor
+    // vezes o tamanho anunciado pelo host
+    const auto maximumChainBlockSize = (size_t)samplesPerBlock * maxOversamplingFactor;
+
+    floatCascade.prepare(useDouble ? 0 : numChannels, maximumChainBlockSize);
+    doubleCascade.prepare(useDouble ? numChannels : 0, maximumChainBlockSize);
+    floatSvfCascade.prepare(useDouble ? 0 : numChannels, maximumChainBlockSize);
+    doubleSvfCascade.prepare(useDouble ? numChannels : 0, maximumChainBlockSize);
+    floatParallelCascade.prepare(useDouble ? 0 : numChannels, maximumChainBlockSize);
+    doubleParallelCascade.prepare(useDouble ? numChannels : 0, maximumChainBlockSize);
+
+    if (useDouble)
+    {
+        prepareOversamplers<double>(numChannels, samplesPerBlock);
+        floatOversamplers = {};
+    }
+    else
+    {
+        prepareOversamplers<float>(numChannels, samplesPerBlock);
+        doubleOversamplers = {};
+    }
+
+    activeOversamplingOrder = getRequestedOversamplingOrder();
+    activeOversamplingFilter = getRequestedOversamplingFilter();
+    filterSampleRate.store(sampleRate * (1 << activeOversamplingOrder));
+
+    // A taxa de amostragem pode ter mudado: todos os filtros são recalculados,
+    // já nos valores atuais, sem rampa
+    activeCoefficientUpdateInterval = coefficientUpdateInterval.load();
+    samplesUntilCoefficientUpdate = activeCoefficientUpdateInterval;
+
+    hostChainSettings = targetChainSettings = getChainSettingsSnapshot();
+    chainSettingsSmoother.reset(sampleRate, smoothingTime.load());
+    chainSettingsSmoother.setCurrentAndTargetValue(targetChainSettings);
+    appliedChainSettingsVersion = 0;
+    samplePosition.store(0);
+    activeFilterEngine = chainSettingsSmoother.getCurrentValue().filterEngine;
+    numMainChannels = (int)numChannels;
+    setStereoMode(getStereoMode(chainSettingsSmoother.getCurrentValue()));
+
+    // Os detectores das bandas dinâmicas medem a entrada ou o sidechain na taxa do host
+    for (auto& detector : bandDetectors)
+        detector.prepare(sampleRate, juce::jmax((int)numChannels, numSidechainChannels), samplesPerBlock);
+
+    dynamicGains.fill(0.f);
+    dynamicLevels.fill(juce::Decibels::gainToDecibels(0.f));
+    detectingBands = sidechainBands = 0;
+
+    designFilters(allFiltersDirty, 0);
+
+    // O primeiro kernel de fase linear é projetado aqui mesmo, com a thread de fundo parada
+    backgroundThread.stopThread(1000);
+
+    linearPhaseSampleRate = sampleRate;
+    linearPhaseConvolver.prepare(sampleRate, numChannels, maxLinearPhaseLength);
+    linearPhaseSettings.publish([this] { return targetChainSettings; });
+    designedLinearPhaseLength = 0;
+
+    updateLinearPhaseKernel();
+    linearPhaseConvolver.reset();
+    linearPhaseActive = isLinearPhaseEnabled();
+
+    sleeping = false;
+    silentSamples = 0;
+    updateTailLength();
+
+    updateLatency();
+    setLatencySamples(reportedLatency.load());
+
+    backgroundThread.startThread();
 
     leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
@@ -167,6 +639,7 @@ void EqualizadorAudioProcessor::releaseResources()
 {
     // Quando a reprodução para, você pode usar isso como uma oportunidade para liberar qualquer
     // memória extra, etc.
+    backgroundThread.stopThread(1000);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -177,14 +650,13 @@ bool EqualizadorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     return true;
   #else
     // Este é o lugar onde você verifica se o layout é suportado.
-    // Neste código de modelo, só suportamos layouts mono ou estéreo.
-    // Alguns hosts de plugin, como certas versões do GarageBand, só carregam
-    // plugins que suportam layouts de barramento estéreo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // A cadeia aloca um estado de filtro por canal em prepareToPlay, então
+    // qualquer layout serve: mono, estéreo ou surround (5.1, 7.1.4, ...).
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
-    // Verifica se o layout de entrada corresponde ao layout de saída
+    // Verifica se o layout de entrada corresponde ao layout de saída. O sidechain
+    // (segunda entrada) pode ficar desligado ou ter qualquer número de canais.
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
@@ -196,6 +668,29 @@ bool EqualizadorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 #endif
 
 void EqualizadorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer);
+}
+
+void EqualizadorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processBlockInternal(buffer);
+}
+
+bool EqualizadorAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void EqualizadorAudioProcessor::audioWorkgroupContextChanged(const juce::AudioWorkgroup& workgroup)
+{
+    linearPhaseConvolver.setAudioWorkgroup(workgroup);
+}
+
+template<typename SampleType>
+void EqualizadorAudioProcessor::processBlockInternal (juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -205,26 +700,190 @@ void EqualizadorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    // A cadeia processa só o barramento principal; os canais de sidechain vêm depois
+    // dele no buffer e apenas alimentam os detectores das bandas dinâmicas
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+    auto sidechainBuffer = getBusCount(true) > 1 ? getBusBuffer(buffer, true, 1) : juce::AudioBuffer<SampleType>();
+
     updateFilters();
 
-    // Cria um AudioBlock a partir do buffer
-    juce::dsp::AudioBlock<float> audioBlock(buffer);
+    // A cadeia IIR continua acompanhando os ajustes no modo de fase linear, mas o
+    // estado de um modo não serve ao outro: quem volta a processar começa do zero
+    if (isLinearPhaseEnabled() != linearPhaseActive)
+    {
+        linearPhaseActive = !linearPhaseActive;
+
+        if (linearPhaseActive)
+        {
+            linearPhaseConvolver.reset();
+        }
+        else
+        {
+            getCascade<SampleType>().reset();
+            getSvfCascade<SampleType>().reset();
+            getParallelCascade<SampleType>().reset();
+        }
+    }
+
+    const auto oversamplingOrder = getRequestedOversamplingOrder();
+    const auto oversamplingFilter = getRequestedOversamplingFilter();
+    if (oversamplingOrder != activeOversamplingOrder || (oversamplingOrder > 0 && oversamplingFilter != activeOversamplingFilter))
+        setOversampling<SampleType>(oversamplingOrder, oversamplingFilter);
 
     //buffer.clear();
     //juce::dsp::ProcessContextReplacing<float> stereoContext(audioBlock);
     //osc.process(stereoContext);
 
-    auto leftAudioBlock = audioBlock.getSingleChannelBlock(0);
-    auto rightAudioBlock = audioBlock.getSingleChannelBlock(1);
+    // Divide o bloco nos pontos da grade de recálculo dos coeficientes, onde também
+    // entram os eventos agendados. O host também pode mandar blocos maiores que o
+    // anunciado em prepareToPlay. Grade e eventos usam posições absolutas, então o
+    // resultado de uma renderização é o mesmo para qualquer tamanho de bloco.
+    const auto maxChunk = (int)getCascade<SampleType>().getMaximumBlockSize() / maxOversamplingFactor;
+
+    // O host precisa chamar prepareToPlay com a mesma precisão que usa em processBlock
+    jassert(maxChunk > 0);
+    if (maxChunk == 0)
+        return;
+
+    const auto blockPosition = samplePosition.load();
+
+    // O silêncio é medido antes do processamento, que é feito no lugar
+    const auto inputSilent = isSilent(mainBuffer);
+    if (!inputSilent)
+    {
+        silentSamples = 0;
+
+        if (sleeping)
+            leaveSleep();
+    }
+
+    for (int start = 0; start < mainBuffer.getNumSamples();)
+    {
+        if (samplesUntilCoefficientUpdate == activeCoefficientUpdateInterval)
+            applyParameterEvents(blockPosition + start);
+
+        const auto numSamples = juce::jmin(maxChunk, samplesUntilCoefficientUpdate, mainBuffer.getNumSamples() - start);
+
+        auto block = juce::dsp::AudioBlock<SampleType>(mainBuffer).getSubBlock((size_t)start, (size_t)numSamples);
+
+        if (linearPhaseActive)
+        {
+            if (sleeping)
+                block.clear();
+            else
+                linearPhaseConvolver.process(mainBuffer, start, numSamples);
+        }
+        else
+        {
+            juce::dsp::AudioBlock<SampleType> sidechainBlock;
+            if (sidechainBuffer.getNumChannels() > 0)
+                sidechainBlock = juce::dsp::AudioBlock<SampleType>(sidechainBuffer).getSubBlock((size_t)start, (size_t)numSamples);
+
+            // Os detectores continuam durante a espera: o sidechain pode não estar em silêncio
+            measureDynamicBands(block, sidechainBlock);
+
+            if (sleeping)
+            {
+                block.clear();
+            }
+            else if (activeOversamplingOrder > 0)
+            {
+                auto& oversampler = *getOversamplers<SampleType>()[(size_t)(activeOversamplingOrder - 1)][(size_t)activeOversamplingFilter];
+                processFilterChain<SampleType>(oversampler.processSamplesUp(block));
+                oversampler.processSamplesDown(block);
+            }
+            else
+            {
+                processFilterChain<SampleType>(block);
+            }
+        }
+
+        start += numSamples;
+        samplesUntilCoefficientUpdate -= numSamples;
+
+        if (samplesUntilCoefficientUpdate == 0)
+        {
+            advanceSmoothing(activeCoefficientUpdateInterval);
+            samplesUntilCoefficientUpdate = activeCoefficientUpdateInterval;
+        }
+    }
+
+    samplePosition.store(blockPosition + mainBuffer.getNumSamples());
+
+    updateTailLength();
+
+    if (inputSilent && !sleeping)
+    {
+        silentSamples += mainBuffer.getNumSamples();
+
+        if (silentSamples >= tailSamples)
+            enterSleep<SampleType>();
+    }
+
+    leftChannelFifo.update(mainBuffer);
+    rightChannelFifo.update(mainBuffer);
+}
+
+template<typename SampleType>
+void EqualizadorAudioProcessor::processFilterChain(const juce::dsp::AudioBlock<SampleType>& block)
+{
+    if (activeFilterEngine == FilterEngine::Engine_Svf)
+        getSvfCascade<SampleType>().process(block);
+    else if (activeFilterEngine == FilterEngine::Engine_Parallel)
+        getParallelCascade<SampleType>().process(block);
+    else
+        getCascade<SampleType>().process(block);
+}
+
+template<typename SampleType>
+void EqualizadorAudioProcessor::prepareOversamplers(size_t numChannels, int samplesPerBlock)
+{
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+
+    // IIR: menor latência, fase não linear perto de Nyquist. FIR: fase linear, mais latência.
+    // Latência inteira nos dois casos, para que o valor informado ao host seja exato.
+    const typename Oversampling::FilterType filterTypes[] = { Oversampling::filterHalfBandPolyphaseIIR,
+                                                              Oversampling::filterHalfBandFIREquiripple };
+
+    auto& oversamplers = getOversamplers<SampleType>();
+
+    for (int order = 1; order <= maxOversamplingOrder; ++order)
+    {
+        for (int filter = 0; filter < numOversamplingFilters; ++filter)
+        {
+            auto& oversampler = oversamplers[(size_t)(order - 1)][(size_t)filter];
+            oversampler = std::make_unique<Oversampling>(numChannels, (size_t)order, filterTypes[filter], true, true);
+            oversampler->initProcessing((size_t)samplesPerBlock);
+
+            oversamplingLatencies[(size_t)(order - 1)][(size_t)filter] = juce::roundToInt(oversampler->getLatencyInSamples());
+        }
+    }
+}
+
+int EqualizadorAudioProcessor::getRequestedOversamplingOrder() const
+{
+    if (oversamplingOfflineOnlyParameter->load() >= 0.5f && !isNonRealtime())
+        return 0;
+
+    return juce::jlimit(0, maxOversamplingOrder, static_cast<int>(oversamplingParameter->load()));
+}
+
+template<typename SampleType>
+void EqualizadorAudioProcessor::setOversampling(int order, int filter)
+{
+    activeOversamplingOrder = order;
+    activeOversamplingFilter = filter;
 
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftAudioBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightAudioBlock);
+    if (order > 0)
+        getOversamplers<SampleType>()[(size_t)(order - 1)][(size_t)filter]->reset();
 
-    leftChannelChain.process(leftContext);
-    rightChannelChain.process(rightContext);
+    // Nova taxa da cadeia: estado zerado e todos os filtros reprojetados, sem rampa
+    filterSampleRate.store(getSampleRate() * (1 << order));
 
-    leftChannelFifo.update(buffer);
-    rightChannelFifo.update(buffer);
+    getCascade<SampleType>().reset();
+    getSvfCascade<SampleType>().reset();
+    getParallelCascade<SampleType>().reset();
+    designFilters(allFiltersDirty, 0);
 }
 
 //==============================================================================
@@ -258,7 +917,10 @@ void EqualizadorAudioProcessor::setStateInformation (const void* data, int sizeI
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if (tree.isValid()) {
         apvts.replaceState(tree);
-        updateFilters();
+
+        // Pode ser chamado fora da thread de áudio: apenas publica os ajustes,
+        // que serão aplicados aos filtros no próximo processBlock
+        publishChainSettings();
     }
 }
 
@@ -269,19 +931,61 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
     return new EqualizadorAudioProcessor();
 }
 
-// Define o Layout dos 3 parâmetros: Low Band, High Band e Parametric/Peak Band
+juce::String getPeakBandParameterID(int band, const juce::String& suffix)
+{
+    jassert(band >= 0 && band < maxPeakBands);
+
+    if (band == 0)
+        return "Peak" + suffix;
+
+    return "Peak " + juce::String(band + 1) + suffix;
+}
+
+// Define o Layout dos parâmetros: Low Band, High Band e as Parametric/Peak Bands
 juce::AudioProcessorValueTreeState::ParameterLayout EqualizadorAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
     layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut", "LowCut", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20.f));
     layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut", "HighCut", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20000.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak", "Peak", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 750.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Gain", "Peak Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Quality", "Peak Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f));
 
-    // Inclinação mínima de 12 dB/oitava para LowCut e HighCut
+    // A primeira banda começa ligada em 750 Hz, como o antigo filtro único; as demais
+    // começam desligadas, espalhadas em escala logarítmica de 20 Hz a 20 kHz
+    for (int band = 0; band < maxPeakBands; ++band)
+    {
+        const auto defaultFreq = band == 0 ? 750.f : std::round(20.f * std::pow(1000.f, (float)band / (float)maxPeakBands));
+
+        const auto freqID = getPeakBandParameterID(band);
+        const auto gainID = getPeakBandParameterID(band, " Gain");
+        const auto qualityID = getPeakBandParameterID(band, " Quality");
+        const auto activeID = getPeakBandParameterID(band, " Active");
+        const auto dynamicID = getPeakBandParameterID(band, " Dynamic");
+        const auto thresholdID = getPeakBandParameterID(band, " Threshold");
+        const auto ratioID = getPeakBandParameterID(band, " Ratio");
+        const auto attackID = getPeakBandParameterID(band, " Attack");
+        const auto releaseID = getPeakBandParameterID(band, " Release");
+        const auto sidechainID = getPeakBandParameterID(band, " Sidechain");
+        const auto placementID = getPeakBandParameterID(band, " Placement");
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(freqID, freqID, juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), defaultFreq));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(gainID, gainID, juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(qualityID, qualityID, juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f));
+        layout.add(std::make_unique<juce::AudioParameterBool>(activeID, activeID, band == 0));
+
+        // Banda dinâmica: limiar em dBFS, razão de compressão e tempos em milissegundos
+        layout.add(std::make_unique<juce::AudioParameterBool>(dynamicID, dynamicID, false));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(thresholdID, thresholdID, juce::NormalisableRange<float>(-60.f, 0.f, 0.5f, 1.f), 0.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(ratioID, ratioID, juce::NormalisableRange<float>(1.f, 20.f, 0.1f, 0.5f), 2.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(attackID, attackID, juce::NormalisableRange<float>(0.1f, 200.f, 0.1f, 0.4f), 10.f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(releaseID, releaseID, juce::NormalisableRange<float>(5.f, 2000.f, 1.f, 0.4f), 100.f));
+        layout.add(std::make_unique<juce::AudioParameterBool>(sidechainID, sidechainID, false));
+
+        // Canais da banda nos modos Left/Right e Mid/Side, na ordem do enum StereoPlacement
+        layout.add(std::make_unique<juce::AudioParameterChoice>(placementID, placementID, juce::StringArray{ "Both", "Left/Mid", "Right/Side" }, 0));
+    }
+
+    // Inclinação de 12 a 96 dB/oitava para LowCut e HighCut
     juce::StringArray strArr;
-    for (int i = 0; i < 4; ++i) 
+    for (int i = 0; i < maxCutFilterSections; ++i) 
     {
         juce::String str;
         str << (12 + 12 * i);
@@ -291,22 +995,302 @@ juce::AudioProcessorValueTreeState::ParameterLayout EqualizadorAudioProcessor::c
 
     layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", strArr, 0)); // Inicializa com 12 dB/oitava
     layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", strArr, 0)); // Inicializa com 12 dB/oitava
+
+    // Família de cada corte, na ordem do enum CutFilterFamily. A inclinação escolhida
+    // define a ordem; Chebyshev e elíptico são mais íngremes que o Butterworth nela.
+    const juce::StringArray families{ "Butterworth", "Chebyshev I", "Chebyshev II", "Elliptic" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Type", "LowCut Type", families, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Type", "HighCut Type", families, 0));
+
+    // Canais de cada corte nos modos Left/Right e Mid/Side, como os das bandas peak
+    const juce::StringArray placements{ "Both", "Left/Mid", "Right/Side" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Placement", "LowCut Placement", placements, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Placement", "HighCut Placement", placements, 0));
+
+    // Motor de filtro, na ordem do enum FilterEngine
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Filter Engine", "Filter Engine", juce::StringArray{ "Biquad", "State Variable", "Parallel" }, 0));
+
+    // Projeto dos coeficientes, na ordem do enum DesignMethod. O casado mantém a forma
+    // analógica perto de Nyquist sem o custo da sobreamostragem.
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Design Method", "Design Method", juce::StringArray{ "Bilinear", "Matched" }, 0));
+
+    // Modo estéreo, na ordem do enum StereoMode
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Stereo Mode", "Stereo Mode", juce::StringArray{ "Linked", "Left/Right", "Mid/Side" }, 0));
+
+    // Fase linear: FIR com a mesma magnitude, ao custo de latência (metade do kernel)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Phase Mode", "Phase Mode", juce::StringArray{ "Minimum", "Linear" }, 0));
+
+    juce::StringArray lengths;
+    for (int length = minLinearPhaseLength; length <= maxLinearPhaseLength; length *= 2)
+        lengths.add(juce::String(length));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Linear Phase Length", "Linear Phase Length", lengths, 2)); // Inicializa com 4096
+
+    // Sobreamostragem da cadeia IIR, contra a compressão da resposta perto de Nyquist
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling", "Oversampling", juce::StringArray{ "Off", "2x", "4x", "8x" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling Filter", "Oversampling Filter", juce::StringArray{ "IIR", "FIR" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>("Oversampling Offline Only", "Oversampling Offline Only", false));
     return layout;
 }
 
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+{
+    return ChainParameterHandles(apvts).load();
+}
+
+ChainParameterHandles::ChainParameterHandles(juce::AudioProcessorValueTreeState& apvts)
+    : lowCutFreq(apvts.getRawParameterValue("LowCut")),
+      highCutFreq(apvts.getRawParameterValue("HighCut")),
+      lowCutSlope(apvts.getRawParameterValue("LowCut Slope")),
+      highCutSlope(apvts.getRawParameterValue("HighCut Slope")),
+      lowCutFamily(apvts.getRawParameterValue("LowCut Type")),
+      highCutFamily(apvts.getRawParameterValue("HighCut Type")),
+      lowCutPlacement(apvts.getRawParameterValue("LowCut Placement")),
+      highCutPlacement(apvts.getRawParameterValue("HighCut Placement")),
+      filterEngine(apvts.getRawParameterValue("Filter Engine")),
+      designMethod(apvts.getRawParameterValue("Design Method")),
+      stereoMode(apvts.getRawParameterValue("Stereo Mode"))
+{
+    for (int band = 0; band < maxPeakBands; ++band)
+    {
+        auto& handles = peakBands[(size_t)band];
+        handles.freq = apvts.getRawParameterValue(getPeakBandParameterID(band));
+        handles.gain = apvts.getRawParameterValue(getPeakBandParameterID(band, " Gain"));
+        handles.quality = apvts.getRawParameterValue(getPeakBandParameterID(band, " Quality"));
+        handles.active = apvts.getRawParameterValue(getPeakBandParameterID(band, " Active"));
+        handles.dynamic = apvts.getRawParameterValue(getPeakBandParameterID(band, " Dynamic"));
+        handles.threshold = apvts.getRawParameterValue(getPeakBandParameterID(band, " Threshold"));
+        handles.ratio = apvts.getRawParameterValue(getPeakBandParameterID(band, " Ratio"));
+        handles.attack = apvts.getRawParameterValue(getPeakBandParameterID(band, " Attack"));
+        handles.release = apvts.getRawParameterValue(getPeakBandParameterID(band, " Release"));
+        handles.sidechain = apvts.getRawParameterValue(getPeakBandParameterID(band, " Sidechain"));
+        handles.placement = apvts.getRawParameterValue(getPeakBandParameterID(band, " Placement"));
+
+        jassert(handles.freq != nullptr && handles.gain != nullptr && handles.quality != nullptr && handles.active != nullptr);
+        jassert(handles.dynamic != nullptr && handles.threshold != nullptr && handles.ratio != nullptr);
+        jassert(handles.attack != nullptr && handles.release != nullptr && handles.sidechain != nullptr);
+        jassert(handles.placement != nullptr);
+    }
+
+    jassert(lowCutFreq != nullptr && highCutFreq != nullptr);
+    jassert(lowCutSlope != nullptr && highCutSlope != nullptr);
+    jassert(lowCutFamily != nullptr && highCutFamily != nullptr);
+    jassert(lowCutPlacement != nullptr && highCutPlacement != nullptr);
+    jassert(filterEngine != nullptr && designMethod != nullptr && stereoMode != nullptr);
+}
+
+ChainSettings ChainParameterHandles::load() const
 {
     ChainSettings settings;
     // Recupera valores do ValueTreeState e atribui à estrutura ChainSettings
-    settings.peakFreq = apvts.getRawParameterValue("Peak")->load();
-    settings.peakGain = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
+    for (size_t band = 0; band < (size_t)maxPeakBands; ++band)
+    {
+        auto& bandSettings = settings.peakBands[band];
+        bandSettings.freq = peakBands[band].freq->load();
+        bandSettings.gain = peakBands[band].gain->load();
+        bandSettings.quality = peakBands[band].quality->load();
+        bandSettings.active = peakBands[band].active->load() >= 0.5f;
+        bandSettings.dynamic = peakBands[band].dynamic->load() >= 0.5f;
+        bandSettings.threshold = peakBands[band].threshold->load();
+        bandSettings.ratio = peakBands[band].ratio->load();
+        bandSettings.attack = peakBands[band].attack->load();
+        bandSettings.release = peakBands[band].release->load();
+        bandSettings.sidechain = peakBands[band].sidechain->load() >= 0.5f;
+        bandSettings.placement = static_cast<StereoPlacement>(static_cast<int>(peakBands[band].placement->load()));
+    }
+
+    settings.lowCutFreq = lowCutFreq->load();
+    settings.highCutFreq = highCutFreq->load();
+
+    settings.lowCutSlope = static_cast<Slope>(static_cast<int>(lowCutSlope->load()));
+    settings.highCutSlope = static_cast<Slope>(static_cast<int>(highCutSlope->load()));
 
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut")->load();
+    settings.lowCutFamily = static_cast<CutFilterFamily>(static_cast<int>(lowCutFamily->load()));
+    settings.highCutFamily = static_cast<CutFilterFamily>(static_cast<int>(highCutFamily->load()));
 
-    settings.lowCutSlope = static_cast<Slope>(static_cast<int>(apvts.getRawParameterValue("LowCut Slope")->load()));
-    settings.highCutSlope = static_cast<Slope>(static_cast<int>(apvts.getRawParameterValue("HighCut Slope")->load()));
+    settings.lowCutPlacement = static_cast<StereoPlacement>(static_cast<int>(lowCutPlacement->load()));
+    settings.highCutPlacement = static_cast<StereoPlacement>(static_cast<int>(highCutPlacement->load()));
+
+    settings.filterEngine = static_cast<FilterEngine>(static_cast<int>(filterEngine->load()));
+    settings.designMethod = static_cast<DesignMethod>(static_cast<int>(designMethod->load()));
+    settings.stereoMode = static_cast<StereoMode>(static_cast<int>(stereoMode->load()));
 
     return settings;
+}
+
+void setChainParameter(ChainSettings& chainSettings, const ParameterEvent& event)
+{
+    const auto value = event.value;
+
+    jassert(event.band >= 0 && event.band < maxPeakBands);
+    auto& band = chainSettings.peakBands[(size_t)juce::jlimit(0, maxPeakBands - 1, event.band)];
+
+    switch (event.parameter)
+    {
+    case ChainParameter::Parameter_PeakFreq:     band.freq = value; break;
+    case ChainParameter::Parameter_PeakGain:     band.gain = value; break;
+    case ChainParameter::Parameter_PeakQuality:  band.quality = value; break;
+    case ChainParameter::Parameter_PeakActive:   band.active = value >= 0.5f; break;
+    case ChainParameter::Parameter_PeakDynamic:  band.dynamic = value >= 0.5f; break;
+    case ChainParameter::Parameter_PeakThreshold: band.threshold = value; break;
+    case ChainParameter::Parameter_PeakRatio:    band.ratio = value; break;
+    case ChainParameter::Parameter_PeakAttack:   band.attack = value; break;
+    case ChainParameter::Parameter_PeakRelease:  band.release = value; break;
+    case ChainParameter::Parameter_PeakSidechain: band.sidechain = value >= 0.5f; break;
+    case ChainParameter::Parameter_PeakPlacement: band.placement = static_cast<StereoPlacement>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_LowCutFreq:   chainSettings.lowCutFreq = value; break;
+    case ChainParameter::Parameter_HighCutFreq:  chainSettings.highCutFreq = value; break;
+    case ChainParameter::Parameter_LowCutSlope:  chainSettings.lowCutSlope = static_cast<Slope>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_HighCutSlope: chainSettings.highCutSlope = static_cast<Slope>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_LowCutFamily: chainSettings.lowCutFamily = static_cast<CutFilterFamily>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_HighCutFamily: chainSettings.highCutFamily = static_cast<CutFilterFamily>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_FilterEngine: chainSettings.filterEngine = static_cast<FilterEngine>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_DesignMethod: chainSettings.designMethod = static_cast<DesignMethod>(static_cast<int>(value)); break;
+    case ChainParameter::Parameter_StereoMode:   chainSettings.stereoMode = static_cast<StereoMode>(static_cast<int>(value)); break;
+    default: jassertfalse; break;
+    }
+}
+
+void ChainSettingsSmoother::reset(double sampleRate, double rampLengthInSeconds)
+{
+    for (auto& band : peakBands)
+    {
+        band.freq.reset(sampleRate, rampLengthInSeconds);
+        band.gain.reset(sampleRate, rampLengthInSeconds);
+        band.quality.reset(sampleRate, rampLengthInSeconds);
+    }
+
+    lowCutFreq.reset(sampleRate, rampLengthInSeconds);
+    highCutFreq.reset(sampleRate, rampLengthInSeconds);
+}
+
+void ChainSettingsSmoother::setCurrentAndTargetValue(const ChainSettings& settings)
+{
+    for (size_t i = 0; i < (size_t)maxPeakBands; ++i)
+    {
+        peakBands[i].freq.setCurrentAndTargetValue(settings.peakBands[i].freq);
+        peakBands[i].gain.setCurrentAndTargetValue(settings.peakBands[i].gain);
+        peakBands[i].quality.setCurrentAndTargetValue(settings.peakBands[i].quality);
+    }
+
+    lowCutFreq.setCurrentAndTargetValue(settings.lowCutFreq);
+    highCutFreq.setCurrentAndTargetValue(settings.highCutFreq);
+
+    current = settings;
+}
+
+int ChainSettingsSmoother::setTargetValue(const ChainSettings& settings)
+{
+    for (size_t i = 0; i < (size_t)maxPeakBands; ++i)
+    {
+        peakBands[i].freq.setTargetValue(settings.peakBands[i].freq);
+        peakBands[i].gain.setTargetValue(settings.peakBands[i].gain);
+        peakBands[i].quality.setTargetValue(settings.peakBands[i].quality);
+    }
+
+    lowCutFreq.setTargetValue(settings.lowCutFreq);
+    highCutFreq.setTargetValue(settings.highCutFreq);
+
+    int changed = 0;
+
+    if (current.lowCutSlope != settings.lowCutSlope || current.lowCutFamily != settings.lowCutFamily
+        || current.lowCutPlacement != settings.lowCutPlacement)
+        changed |= 1 << ChainPositions::LowCut;
+
+    if (current.highCutSlope != settings.highCutSlope || current.highCutFamily != settings.highCutFamily
+        || current.highCutPlacement != settings.highCutPlacement)
+        changed |= 1 << ChainPositions::HighCut;
+
+    if (current.filterEngine != settings.filterEngine || current.designMethod != settings.designMethod
+        || current.stereoMode != settings.stereoMode)
+        changed |= allChainPositions;
+
+    for (size_t i = 0; i < (size_t)maxPeakBands; ++i)
+    {
+        if (current.peakBands[i].active != settings.peakBands[i].active
+            || current.peakBands[i].placement != settings.peakBands[i].placement)
+            changed |= getPeakBandBit((int)i);
+
+        current.peakBands[i].active = settings.peakBands[i].active;
+        current.peakBands[i].placement = settings.peakBands[i].placement;
+
+        // Os ajustes dinâmicos são lidos pelo detector a cada sub-bloco, sem suavização
+        current.peakBands[i].dynamic = settings.peakBands[i].dynamic;
+        current.peakBands[i].threshold = settings.peakBands[i].threshold;
+        current.peakBands[i].ratio = settings.peakBands[i].ratio;
+        current.peakBands[i].attack = settings.peakBands[i].attack;
+        current.peakBands[i].release = settings.peakBands[i].release;
+        current.peakBands[i].sidechain = settings.peakBands[i].sidechain;
+    }
+
+    current.lowCutSlope = settings.lowCutSlope;
+    current.highCutSlope = settings.highCutSlope;
+    current.lowCutFamily = settings.lowCutFamily;
+    current.highCutFamily = settings.highCutFamily;
+    current.lowCutPlacement = settings.lowCutPlacement;
+    current.highCutPlacement = settings.highCutPlacement;
+    current.filterEngine = settings.filterEngine;
+    current.designMethod = settings.designMethod;
+    current.stereoMode = settings.stereoMode;
+
+    // Com tempo de rampa zero o SmoothedValue salta direto para o alvo
+    auto jumped = [](const auto& smoothed, float& value)
+        {
+            if (smoothed.isSmoothing() || smoothed.getCurrentValue() == value)
+                return false;
+
+            value = smoothed.getCurrentValue();
+            return true;
+        };
+
+    if (jumped(lowCutFreq, current.lowCutFreq))
+        changed |= 1 << ChainPositions::LowCut;
+
+    for (size_t i = 0; i < (size_t)maxPeakBands; ++i)
+    {
+        auto& band = current.peakBands[i];
+
+        if ((jumped(peakBands[i].freq, band.freq) | jumped(peakBands[i].gain, band.gain) | jumped(peakBands[i].quality, band.quality)) && band.active)
+            changed |= getPeakBandBit((int)i);
+    }
+
+    if (jumped(highCutFreq, current.highCutFreq))
+        changed |= 1 << ChainPositions::HighCut;
+
+    return changed;
+}
+
+int ChainSettingsSmoother::skip(int numSamples)
+{
+    int smoothing = 0;
+
+    if (lowCutFreq.isSmoothing())
+    {
+        smoothing |= 1 << ChainPositions::LowCut;
+        current.lowCutFreq = lowCutFreq.skip(numSamples);
+    }
+
+    if (highCutFreq.isSmoothing())
+    {
+        smoothing |= 1 << ChainPositions::HighCut;
+        current.highCutFreq = highCutFreq.skip(numSamples);
+    }
+
+    // Só as bandas em rampa avançam; com todas paradas o laço apenas consulta os estados
+    for (size_t i = 0; i < (size_t)maxPeakBands; ++i)
+    {
+        auto& smoother = peakBands[i];
+        if (!smoother.isSmoothing())
+            continue;
+
+        auto& band = current.peakBands[i];
+        band.freq = smoother.freq.skip(numSamples);
+        band.gain = smoother.gain.skip(numSamples);
+        band.quality = smoother.quality.skip(numSamples);
+
+        if (band.active)
+            smoothing |= getPeakBandBit((int)i);
+    }
+
+    return smoothing;
 }
\ No newline at end of file
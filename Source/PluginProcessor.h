@@ -9,9 +9,17 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BiquadDesign.h"
+#include "BiquadCascade.h"
+#include "SvfCascade.h"
+#include "ParallelCascade.h"
+#include "LinearPhaseConvolver.h"
+#include "DynamicBands.h"
 
 //==============================================================================
 #include <array>
+#include <atomic>
+#include <thread>
 template<typename T>
 struct Fifo
 {
@@ -75,6 +83,89 @@ private:
     juce::AbstractFifo fifo{ Capacity };
 };
 
+// Publica um valor imutável para leitores em qualquer thread usando um seqlock.
+// Os leitores nunca bloqueiam: tryRead() falha se uma escrita estiver em andamento.
+// Escritores concorrentes não esperam uns pelos outros: quem chega durante uma
+// escrita apenas pede que o escritor atual produza o valor de novo.
+template<typename T>
+struct SeqLockSnapshot
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLockSnapshot only holds trivially copyable types");
+
+    template<typename Producer>
+    void publish(Producer&& produce)
+    {
+        pending.store(true);
+
+        while (pending.load())
+        {
+            auto expected = false;
+            if (!writing.compare_exchange_strong(expected, true))
+                return; // o escritor atual verá 'pending' e publicará de novo
+
+            pending.store(false);
+            write(produce());
+            writing.store(false);
+        }
+    }
+
+    bool tryRead(T& value, uint32_t& version) const
+    {
+        auto before = sequence.load(std::memory_order_acquire);
+        if (before & 1u)
+            return false;
+
+        std::array<uint32_t, numWords> copy;
+        for (size_t i = 0; i < numWords; ++i)
+            copy[i] = words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before)
+            return false;
+
+        std::memcpy(&value, copy.data(), sizeof(T));
+        version = before / 2;
+        return true;
+    }
+
+    // Para threads que podem esperar (ex.: a thread de mensagens)
+    T read() const
+    {
+        T value;
+        uint32_t version;
+        while (!tryRead(value, version))
+            std::this_thread::yield();
+
+        return value;
+    }
+
+    uint32_t getVersion() const
+    {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+private:
+    static constexpr size_t numWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    void write(const T& value)
+    {
+        std::array<uint32_t, numWords> copy{};
+        std::memcpy(copy.data(), &value, sizeof(T));
+
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < numWords; ++i)
+            words[i].store(copy[i], std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    std::atomic<uint32_t> sequence{ 0 };
+    std::array<std::atomic<uint32_t>, numWords> words{};
+    std::atomic<bool> writing{ false }, pending{ false };
+};
+
 enum Channel
 {
     Right, // Efetivamente 0
@@ -91,22 +182,23 @@ struct SingleChannelSampleFifo
         prepared.set(false);
     }
 
-    // Função para atualizar o FIFO com novos dados de áudio
-    void update(const BlockType& buffer)
+    // Função para atualizar o FIFO com novos dados de áudio (float ou double)
+    template<typename SourceSampleType>
+    void update(const juce::AudioBuffer<SourceSampleType>& buffer)
     {
         // Verifica se a estrutura está preparada para uso
         jassert(prepared.get());
 
-        // Verifica se o buffer de áudio tem canais suficientes
-        jassert(buffer.getNumChannels() > channelToUse);
+        // Em layouts com menos canais (ex.: mono) usa o último canal disponível
+        jassert(buffer.getNumChannels() > 0);
 
         // Obtém o ponteiro para o canal de áudio especificado
-        auto* channelPtr = buffer.getReadPointer(channelToUse);
+        auto* channelPtr = buffer.getReadPointer(juce::jmin((int)channelToUse, buffer.getNumChannels() - 1));
 
         // Insere cada amostra do canal no FIFO
         for (int i = 0; i < buffer.getNumSamples(); ++i)
         {
-            pushNextSampleIntoFifo(channelPtr[i]);
+            pushNextSampleIntoFifo(static_cast<float>(channelPtr[i]));
         }
     }
 
@@ -208,82 +300,359 @@ enum Slope
     Slope_12,
     Slope_24,
     Slope_36,
-    Slope_48
+    Slope_48,
+    Slope_60,
+    Slope_72,
+    Slope_84,
+    Slope_96
+};
+
+// Motor usado para processar a cadeia. Todos têm a mesma resposta de magnitude;
+// o de variáveis de estado aceita mudanças de coeficiente a cada amostra e o
+// paralelo soma os termos da expansão em frações parciais dos mesmos biquads
+// (ou volta à cascata, se a expansão for mal condicionada).
+enum FilterEngine
+{
+    Engine_Biquad,
+    Engine_Svf,
+    Engine_Parallel
+};
+
+// Ajustes de uma banda paramétrica (peak). Com 'dynamic' o ganho é reduzido quando
+// o nível da banda passa de 'threshold' (dB), na razão 'ratio', com tempos de
+// ataque e de repouso em milissegundos.
+struct PeakBandSettings
+{
+    float freq{ 0 }, gain{ 0 }, quality{ 1.f };
+    bool active{ false };
+
+    bool dynamic{ false };
+    float threshold{ 0 }, ratio{ 2.f }, attack{ 10.f }, release{ 100.f };
+
+    // O detector mede o barramento de sidechain em vez do sinal principal
+    bool sidechain{ false };
+
+    // Canais afetados nos modos estéreo Left/Right e Mid/Side
+    StereoPlacement placement{ StereoPlacement::Placement_Both };
+};
+
+// Como a cadeia trata um par estéreo: os mesmos filtros nos dois canais, bandas
+// posicionadas em esquerdo/direito ou em mid/side. Fora de layouts estéreo,
+// e no modo de fase linear, vale sempre Linked.
+enum StereoMode
+{
+    Stereo_Linked,
+    Stereo_LeftRight,
+    Stereo_MidSide
 };
 
 // Configura��o dos filtros
 struct ChainSettings
 {
-    float peakFreq{ 0 }, peakGain{ 0 }, peakQuality{ 1.f };
+    std::array<PeakBandSettings, maxPeakBands> peakBands;
     float lowCutFreq{ 0 }, highCutFreq{ 0 };
     Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
+    CutFilterFamily lowCutFamily{ CutFilterFamily::Family_Butterworth }, highCutFamily{ CutFilterFamily::Family_Butterworth };
+
+    // Canais afetados por cada corte nos modos estéreo Left/Right e Mid/Side
+    StereoPlacement lowCutPlacement{ StereoPlacement::Placement_Both }, highCutPlacement{ StereoPlacement::Placement_Both };
+
+    FilterEngine filterEngine{ FilterEngine::Engine_Biquad };
+    DesignMethod designMethod{ DesignMethod::Design_Bilinear };
+    StereoMode stereoMode{ StereoMode::Stereo_Linked };
 };
 
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 
+// ID do parâmetro 'suffix' ("", " Gain", " Quality", " Active", " Dynamic",
+// " Threshold", " Ratio", " Attack", " Release", " Sidechain" ou " Placement") da banda 'band',
+// contada a partir de zero. A primeira banda mantém os IDs do antigo filtro único
+// ("Peak", "Peak Gain", ...); as demais são "Peak 2", "Peak 2 Gain" e assim por diante.
+juce::String getPeakBandParameterID(int band, const juce::String& suffix = {});
+
+// Ponteiros para os valores brutos dos parâmetros da cadeia, resolvidos uma única
+// vez, para que ler os ajustes não precise procurar os parâmetros pelo nome.
+struct ChainParameterHandles
+{
+    explicit ChainParameterHandles(juce::AudioProcessorValueTreeState& apvts);
+
+    ChainSettings load() const;
+private:
+    struct PeakBandHandles
+    {
+        std::atomic<float>* freq;
+        std::atomic<float>* gain;
+        std::atomic<float>* quality;
+        std::atomic<float>* active;
+        std::atomic<float>* dynamic;
+        std::atomic<float>* threshold;
+        std::atomic<float>* ratio;
+        std::atomic<float>* attack;
+        std::atomic<float>* release;
+        std::atomic<float>* sidechain;
+        std::atomic<float>* placement;
+    };
+
+    std::array<PeakBandHandles, maxPeakBands> peakBands;
+    std::atomic<float>* lowCutFreq;
+    std::atomic<float>* highCutFreq;
+    std::atomic<float>* lowCutSlope;
+    std::atomic<float>* highCutSlope;
+    std::atomic<float>* lowCutFamily;
+    std::atomic<float>* highCutFamily;
+    std::atomic<float>* lowCutPlacement;
+    std::atomic<float>* highCutPlacement;
+    std::atomic<float>* filterEngine;
+    std::atomic<float>* designMethod;
+    std::atomic<float>* stereoMode;
+};
+
+// Ajustes da cadeia que podem ser alterados por eventos com marca de tempo
+enum ChainParameter
+{
+    Parameter_PeakFreq,
+    Parameter_PeakGain,
+    Parameter_PeakQuality,
+    Parameter_PeakActive,
+    Parameter_PeakDynamic,
+    Parameter_PeakThreshold,
+    Parameter_PeakRatio,
+    Parameter_PeakAttack,
+    Parameter_PeakRelease,
+    Parameter_PeakSidechain,
+    Parameter_PeakPlacement,
+    Parameter_LowCutFreq,
+    Parameter_HighCutFreq,
+    Parameter_LowCutSlope,
+    Parameter_HighCutSlope,
+    Parameter_LowCutFamily,
+    Parameter_HighCutFamily,
+    Parameter_FilterEngine,
+    Parameter_DesignMethod,
+    Parameter_StereoMode
+};
+
+// Mudança de um ajuste em uma posição da linha do tempo do processador (amostras
+// processadas desde o último prepareToPlay), arredondada para a grade de recálculo
+struct ParameterEvent
+{
+    juce::int64 samplePosition{ 0 };
+    ChainParameter parameter{ ChainParameter::Parameter_PeakFreq };
+    float value{ 0.f };
+
+    // Banda alterada pelos parâmetros Parameter_Peak*, a partir de zero
+    int band{ 0 };
+};
+
+void setChainParameter(ChainSettings& chainSettings, const ParameterEvent& event);
+
+// Fila de eventos de capacidade fixa. Qualquer thread pode chamar push(): os
+// escritores se serializam entre si, mas nunca com o leitor. peek()/pop() são
+// usados apenas na thread de áudio e não alocam nem bloqueiam.
+// Os eventos devem chegar em ordem de samplePosition; um evento fora de ordem
+// é aplicado assim que chega à frente da fila.
+struct ParameterEventQueue
+{
+    static constexpr int Capacity = 1024;
+
+    bool push(const ParameterEvent& event)
+    {
+        const juce::SpinLock::ScopedLockType lock(writeLock);
+
+        auto write = fifo.write(1);
+        if (write.blockSize1 > 0)
+        {
+            events[(size_t)write.startIndex1] = event;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool peek(ParameterEvent& event) const
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        if (size1 > 0)
+        {
+            event = events[(size_t)start1];
+            return true;
+        }
+
+        return false;
+    }
+
+    void pop()
+    {
+        fifo.finishedRead(1);
+    }
+private:
+    std::array<ParameterEvent, Capacity> events;
+    juce::AbstractFifo fifo{ Capacity };
+    juce::SpinLock writeLock;
+};
+
+// Bits das posições da cadeia: os dois cortes e, a partir de Peak, um por banda
 enum ChainPositions
 {
     LowCut,
-    Peak,
-    HighCut
+    HighCut,
+    Peak
 };
 
-void updateCoefficients(juce::dsp::IIR::Filter<float>::CoefficientsPtr& old, const juce::dsp::IIR::Filter<float>::CoefficientsPtr& replacements);
+static_assert(ChainPositions::Peak + maxPeakBands < 31, "as posições da cadeia precisam caber em um int");
 
-juce::dsp::IIR::Filter<float>::CoefficientsPtr makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
+constexpr int getPeakBandBit(int band) { return 1 << (ChainPositions::Peak + band); }
 
-template<int index, typename ChainType, typename CoefficientType>
-void update(ChainType& chain, const CoefficientType& coefficients)
+constexpr int allPeakBandBits = ((1 << maxPeakBands) - 1) << ChainPositions::Peak;
+constexpr int allChainPositions = (1 << ChainPositions::LowCut) | (1 << ChainPositions::HighCut) | allPeakBandBits;
+
+// Suaviza os ajustes contínuos da cadeia (frequências, ganhos e qualidades) para
+// evitar o "zipper" quando um parâmetro salta. As inclinações e o estado ligado
+// ou desligado das bandas mudam imediatamente.
+struct ChainSettingsSmoother
 {
-    updateCoefficients(chain.template get<index>().coefficients, coefficients[index]);
-    chain.template setBypassed<index>(false);
+    void reset(double sampleRate, double rampLengthInSeconds);
+
+    void setCurrentAndTargetValue(const ChainSettings& settings);
+
+    // Devolve os bits das posições da cadeia cuja inclinação, família ou posicionamento
+    // mudou ou que foram ligadas, desligadas ou reposicionadas (todas, se mudou o motor,
+    // o método de projeto ou o modo estéreo)
+    int setTargetValue(const ChainSettings& settings);
+
+    // Avança numSamples e devolve os bits das posições da cadeia que ainda estavam em
+    // rampa. Bandas desligadas continuam a rampa, mas não marcam sua posição.
+    int skip(int numSamples);
+
+    const ChainSettings& getCurrentValue() const { return current; }
+private:
+    struct PeakBandSmoother
+    {
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> freq, quality;
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gain;
+
+        bool isSmoothing() const { return freq.isSmoothing() || gain.isSmoothing() || quality.isSmoothing(); }
+    };
+
+    std::array<PeakBandSmoother, maxPeakBands> peakBands;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowCutFreq, highCutFreq;
+
+    ChainSettings current;
+};
+
+// Número de seções de segunda ordem de um corte com a inclinação dada.
+// Slope Choice 0: 12 dB/oct -> Filtro de 2 ordem -> 1 seção
+// Slope Choice 1: 24 dB/oct -> Filtro de 4 ordem -> 2 seções
+// Slope Choice 2: 36 dB/oct -> Filtro de 6 ordem -> 3 seções
+// Slope Choice 3: 48 dB/oct -> Filtro de 8 ordem -> 4 seções
+// ...
+// Slope Choice 7: 96 dB/oct -> Filtro de 16 ordem -> 8 seções
+constexpr int getNumCutSections(Slope slope) { return slope + 1; }
+
+static_assert(getNumCutSections(Slope_96) == maxCutFilterSections, "a cascata precisa comportar o corte mais inclinado");
+
+// Ganho até o qual uma banda peak é tratada como identidade. A magnitude do bell
+// fica entre 0 dB e o ganho da banda (atingido no centro, nos dois métodos de
+// projeto), então este é o desvio máximo de 20 Hz a Nyquist.
+constexpr float neutralPeakGainDb = 0.01f;
+
+// Só bandas ligadas e fora da tolerância entram na cascata
+inline bool isPeakBandAudible(const PeakBandSettings& settings)
+{
+    return settings.active && std::abs(settings.gain) > neutralPeakGainDb;
 }
 
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType& cut, const CoefficientType& cutCoefficients, const Slope& slope)
+inline BiquadCoefficients makePeakCoefficients(const PeakBandSettings& settings, DesignMethod designMethod, double sampleRate)
 {
-    // Inicializa todos os filtros como bypassed.
-    cut.template setBypassed<0>(true);
-    cut.template setBypassed<1>(true);
-    cut.template setBypassed<2>(true);
-    cut.template setBypassed<3>(true);
-
-    // Define os coeficientes e desativa o bypass de acordo com a inclinação.
-    switch (slope)
-    {
-    case Slope_48:
-        update<3>(cut, cutCoefficients);
+    return makePeakCoefficients(sampleRate, settings.freq, settings.quality, juce::Decibels::decibelsToGain((double)settings.gain), designMethod);
+}
 
-    case Slope_36:
-        update<2>(cut, cutCoefficients);
+inline BiquadCoefficients makePeakCoefficients(const ChainSettings& chainSettings, int band, double sampleRate)
+{
+    return makePeakCoefficients(chainSettings.peakBands[(size_t)band], chainSettings.designMethod, sampleRate);
+}
 
-    case Slope_24:
-        update<1>(cut, cutCoefficients);
+inline PeakBandCoefficients makePeakBandCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    PeakBandCoefficients peaks;
 
-    case Slope_12:
-        update<0>(cut, cutCoefficients);
+    for (int band = 0; band < maxPeakBands; ++band)
+    {
+        peaks.active[(size_t)band] = isPeakBandAudible(chainSettings.peakBands[(size_t)band]);
+        peaks.placement[(size_t)band] = chainSettings.stereoMode == StereoMode::Stereo_Linked ? StereoPlacement::Placement_Both
+                                                                                            : chainSettings.peakBands[(size_t)band].placement;
 
+        if (peaks.active[(size_t)band])
+            peaks.bands[(size_t)band] = makePeakCoefficients(chainSettings, band, sampleRate);
     }
+
+    return peaks;
+}
+
+inline CutFilterCoefficients makeLowCutCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    // Desenha os coeficientes de um filtro passa-altas de alta ordem da família escolhida
+    // `chainSettings.lowCutSlope` representa a inclinação desejada do filtro
+    return makeCutFilterHighPass(sampleRate, chainSettings.lowCutFreq, 2 * getNumCutSections(chainSettings.lowCutSlope),
+                                 chainSettings.lowCutFamily, chainSettings.designMethod);
+}
+
+inline CutFilterCoefficients makeHighCutCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    return makeCutFilterLowPass(sampleRate, chainSettings.highCutFreq, 2 * getNumCutSections(chainSettings.highCutSlope),
+                                chainSettings.highCutFamily, chainSettings.designMethod);
 }
 
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
+inline ChainCoefficients makeChainCoefficients(const ChainSettings& chainSettings, double sampleRate)
 {
-    // Desenha os coeficientes de um filtro passa-altas de Butterworth de alta ordem
-    // `chainSettings.lowCutSlope` representa a inclinação desejada do filtro:
-    // Slope Choice 0: 12 dB/oct -> Filtro de 2 ordem
-    // Slope Choice 1: 24 dB/oct -> Filtro de 4 ordem
-    // Slope Choice 2: 36 dB/oct -> Filtro de 6 ordem
-    // Slope Choice 3: 48 dB/oct -> Filtro de 8 ordem
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
+    ChainCoefficients chain;
+    chain.lowCut = makeLowCutCoefficients(chainSettings, sampleRate);
+    chain.peaks = makePeakBandCoefficients(chainSettings, sampleRate);
+    chain.highCut = makeHighCutCoefficients(chainSettings, sampleRate);
+
+    // No modo Linked os cortes valem para os dois canais
+    const auto linked = chainSettings.stereoMode == StereoMode::Stereo_Linked;
+    chain.lowCutPlacement = linked ? StereoPlacement::Placement_Both : chainSettings.lowCutPlacement;
+    chain.highCutPlacement = linked ? StereoPlacement::Placement_Both : chainSettings.highCutPlacement;
+
+    return chain;
+}
+
+inline SvfCoefficients makeSvfPeakCoefficients(const PeakBandSettings& settings, DesignMethod designMethod, double sampleRate)
+{
+    if (designMethod == DesignMethod::Design_Matched)
+        return makeSvfCoefficients(makePeakCoefficients(settings, designMethod, sampleRate));
+
+    return makeSvfPeakCoefficients(sampleRate, settings.freq, settings.quality, juce::Decibels::decibelsToGain((double)settings.gain));
 }
 
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
+inline SvfCoefficients makeSvfPeakCoefficients(const ChainSettings& chainSettings, int band, double sampleRate)
 {
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1));
+    return makeSvfPeakCoefficients(chainSettings.peakBands[(size_t)band], chainSettings.designMethod, sampleRate);
+}
+
+// Só o Butterworth bilinear tem projeto SVF direto; os demais são convertidos das seções biquad
+inline SvfCutCoefficients makeSvfLowCutCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    if (chainSettings.designMethod == DesignMethod::Design_Matched || chainSettings.lowCutFamily != CutFilterFamily::Family_Butterworth)
+        return makeSvfCutCoefficients(makeLowCutCoefficients(chainSettings, sampleRate));
+
+    return makeSvfButterworthHighPass(sampleRate, chainSettings.lowCutFreq, 2 * getNumCutSections(chainSettings.lowCutSlope));
+}
+
+inline SvfCutCoefficients makeSvfHighCutCoefficients(const ChainSettings& chainSettings, double sampleRate)
+{
+    if (chainSettings.designMethod == DesignMethod::Design_Matched || chainSettings.highCutFamily != CutFilterFamily::Family_Butterworth)
+        return makeSvfCutCoefficients(makeHighCutCoefficients(chainSettings, sampleRate));
+
+    return makeSvfButterworthLowPass(sampleRate, chainSettings.highCutFreq, 2 * getNumCutSections(chainSettings.highCutSlope));
 }
 /**
 */
-class EqualizadorAudioProcessor  : public juce::AudioProcessor
+class EqualizadorAudioProcessor  : public juce::AudioProcessor,
+                                   private juce::AudioProcessorValueTreeState::Listener,
+                                   private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -299,6 +668,14 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // A cadeia é instanciada também para double, então hosts com motor de mixagem
+    // de 64 bits não precisam converter cada bloco para float
+    bool supportsDoublePrecisionProcessing() const override;
+
+    // A thread de trabalho da fase linear entra no workgroup de áudio do host
+    void audioWorkgroupContextChanged(const juce::AudioWorkgroup& workgroup) override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -327,33 +704,295 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts{ *this, nullptr, "Parameters", createParameterLayout()};
 
+    // Cópia consistente dos ajustes atuais, sem busca de parâmetros por nome.
+    // Pode ser chamada de qualquer thread que possa esperar (ex.: o editor).
+    ChainSettings getChainSettingsSnapshot() const { return chainSettingsSnapshot.read(); }
+
+    // Durante a suavização os coeficientes são recalculados a cada 'numSamples'
+    // amostras, em uma grade que não depende do tamanho de bloco do host.
+    // Estes ajustes passam a valer no próximo prepareToPlay.
+    void setCoefficientUpdateInterval(int numSamples);
+    void setSmoothingTime(double seconds);
+
+    static constexpr int defaultCoefficientUpdateInterval = 32;
+    static constexpr double defaultSmoothingTime = 0.05;
+
+    // Agenda a mudança de um ajuste em uma posição da linha do tempo. O evento entra
+    // no ponto da grade de recálculo dos coeficientes mais próximo, sem dividir o
+    // bloco, então o resultado não depende do tamanho de bloco do host. Os wrappers
+    // do JUCE entregam a automação do host sem posição, no início do bloco; esta
+    // é a entrada para quem conhece a posição (renderização offline, sequenciador
+    // interno). Devolve false se a fila estiver cheia.
+    bool scheduleParameterEvent(const ParameterEvent& event) { return parameterEvents.push(event); }
+
+    // Posição atual da linha do tempo usada por ParameterEvent::samplePosition
+    juce::int64 getSamplePosition() const { return samplePosition.load(); }
+
+    // Comprimentos de kernel do modo de fase linear: 1024 << índice do parâmetro
+    static constexpr int minLinearPhaseLength = 1024;
+    static constexpr int maxLinearPhaseLength = 16384;
+
+    // Sobreamostragem da cadeia IIR: 2^ordem, até 8x
+    static constexpr int maxOversamplingOrder = 3;
+    static constexpr int maxOversamplingFactor = 1 << maxOversamplingOrder;
+
+    // Taxa em que os filtros IIR são projetados (a do host vezes a sobreamostragem).
+    // O editor a usa para desenhar a curva que o processador realmente aplica.
+    double getFilterSampleRate() const { return filterSampleRate.load(); }
+
     SingleChannelSampleFifo <juce::AudioBuffer<float>> leftChannelFifo{ Channel::Left };
     SingleChannelSampleFifo <juce::AudioBuffer<float>> rightChannelFifo{ Channel::Right };
 private:
-    // Cadeia de processamento para o canal esquerdo e direito
-    juce::dsp::ProcessorChain<
-        juce::dsp::ProcessorChain<
-        juce::dsp::IIR::Filter<float>, // Primeiro filtro na cadeia LowCut
-        juce::dsp::IIR::Filter<float>, // Segundo filtro na cadeia LowCut
-        juce::dsp::IIR::Filter<float>, // Terciero filtro na cadeia LowCut
-        juce::dsp::IIR::Filter<float> // Quarto filtro na cadeia LowCut
-        >, 
-        juce::dsp::IIR::Filter<float>, // Filtro intermediario
-        juce::dsp::ProcessorChain<
-        juce::dsp::IIR::Filter<float>, // Primeiro filtro na cadeia HighCut
-        juce::dsp::IIR::Filter<float>, // Segundo filtro na cadeia HighCut
-        juce::dsp::IIR::Filter<float>, // Terciero filtro na cadeia HighCut
-        juce::dsp::IIR::Filter<float> // Quarto filtro na cadeia HighCut
-        >
-    > leftChannelChain, rightChannelChain;
-
-    void updatePeakFilter(const ChainSettings& chainSettings);
+    // Coeficientes atuais de LowCut (até 8 seções), das bandas peak e de HighCut
+    // (até 8 seções), mantidos apenas para o motor em uso
+    ChainCoefficients chainCoefficients;
+    SvfChainCoefficients svfChainCoefficients;
+
+    // A cadeia para cada precisão e motor; só a precisão que o host usa tem memória
+    // alocada. Os coeficientes são projetados uma vez, em double, e servem às duas.
+    MultichannelCascade<float> floatCascade;
+    MultichannelCascade<double> doubleCascade;
+    MultichannelCascade<float, SvfCascade> floatSvfCascade;
+    MultichannelCascade<double, SvfCascade> doubleSvfCascade;
+    ParallelCascade<float> floatParallelCascade;
+    ParallelCascade<double> doubleParallelCascade;
+
+    // Usados apenas na thread de áudio
+    FilterEngine activeFilterEngine{ FilterEngine::Engine_Biquad };
+    StereoMode activeStereoMode{ StereoMode::Stereo_Linked };
+
+    // Canais do barramento principal, escrito em prepareToPlay
+    int numMainChannels{ 0 };
+
+    // Modo estéreo pedido, se o layout do barramento principal for estéreo
+    StereoMode getStereoMode(const ChainSettings& chainSettings) const;
+
+    // Troca o modo estéreo das quatro cascatas, zerando o estado delas
+    void setStereoMode(StereoMode stereoMode);
+
+    template<typename SampleType>
+    MultichannelCascade<SampleType>& getCascade()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleCascade;
+        else
+            return floatCascade;
+    }
+
+    template<typename SampleType>
+    MultichannelCascade<SampleType, SvfCascade>& getSvfCascade()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleSvfCascade;
+        else
+            return floatSvfCascade;
+    }
+
+    template<typename SampleType>
+    ParallelCascade<SampleType>& getParallelCascade()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleParallelCascade;
+        else
+            return floatParallelCascade;
+    }
+
+    template<typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+
+    void updatePeakFilter(const ChainSettings& chainSettings, int band);
 
     void updateLowCutFilters(const ChainSettings& chainSettings);
     void updateHighCutFilters(const ChainSettings& chainSettings);
 
+    // Lê novos ajustes, se houver, e os entrega à suavização. Em blocos sem mudança
+    // de parâmetro nem rampa em andamento não aloca nem chama funções trigonométricas.
     void updateFilters();
 
+    // Avança a suavização por um passo da grade e recalcula os grupos ainda em rampa
+    // e as bandas dinâmicas cujo ganho mudou
+    void advanceSmoothing(int numSamples);
+
+    // Aplica, no ponto da grade 'gridPosition', os eventos com marca de tempo mais
+    // próximos dele do que do ponto seguinte
+    void applyParameterEvents(juce::int64 gridPosition);
+
+    // Recalcula os grupos indicados a partir dos valores suavizados atuais. O motor de
+    // variáveis de estado chega aos novos coeficientes ao longo de rampLength amostras.
+    void designFilters(int chainPositions, int rampLength);
+
+    // Mede 'block' ou, nas bandas ligadas ao sidechain, 'sidechain' (na taxa do host,
+    // antes da cadeia) nos detectores das bandas dinâmicas. Sem canais de sidechain,
+    // todas medem 'block'.
+    template<typename SampleType>
+    void measureDynamicBands(const juce::dsp::AudioBlock<SampleType>& block, const juce::dsp::AudioBlock<SampleType>& sidechain);
+
+    // Lê os níveis medidos e devolve os bits das bandas cujo ganho dinâmico mudou.
+    // Chamada só nos pontos da grade, para que o resultado não dependa de onde o
+    // host corta os blocos.
+    int updateDynamicGains();
+
+    // Usados apenas na thread de áudio: um detector por banda, preparados em
+    // prepareToPlay, o último nível medido (dB), o ganho (dB) que cada banda dinâmica
+    // soma ao do parâmetro e, em bits por banda, quais detectores estão medindo e
+    // quais medem o sidechain
+    std::array<BandDetector, maxPeakBands> bandDetectors;
+    std::array<float, maxPeakBands> dynamicLevels{};
+    std::array<float, maxPeakBands> dynamicGains{};
+    int detectingBands{ 0 }, sidechainBands{ 0 };
+
+    ChainSettingsSmoother chainSettingsSmoother;
+
+    std::atomic<int> coefficientUpdateInterval{ defaultCoefficientUpdateInterval };
+    std::atomic<double> smoothingTime{ defaultSmoothingTime };
+
+    // Posição na grade de recálculo, preservada entre blocos
+    int activeCoefficientUpdateInterval{ defaultCoefficientUpdateInterval };
+    int samplesUntilCoefficientUpdate{ defaultCoefficientUpdateInterval };
+
+    // Bits de dirtyFilters, um por posição da cadeia
+    static constexpr int allFiltersDirty = allChainPositions;
+    std::atomic<int> dirtyFilters{ allFiltersDirty };
+
+    ChainParameterHandles chainParameters{ apvts };
+    SeqLockSnapshot<ChainSettings> chainSettingsSnapshot;
+
+    // Usados apenas na thread de áudio: versão e conteúdo do último snapshot entregue
+    // à suavização e os alvos atuais, que os eventos alteram um ajuste por vez
+    uint32_t appliedChainSettingsVersion{ 0 };
+    ChainSettings hostChainSettings, targetChainSettings;
+
+    ParameterEventQueue parameterEvents;
+    std::atomic<juce::int64> samplePosition{ 0 };
+
+    void publishChainSettings();
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    //==============================================================================
+    // Sobreamostragem em volta da cadeia IIR, com filtros meia-banda polifásicos.
+    // Um sobreamostrador por ordem (2x, 4x, 8x) e tipo de filtro (IIR, FIR), todos
+    // preparados em prepareToPlay para a precisão em uso: trocar não aloca.
+    static constexpr int numOversamplingFilters = 2;
+
+    template<typename SampleType>
+    using Oversamplers = std::array<std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, numOversamplingFilters>, maxOversamplingOrder>;
+
+    Oversamplers<float> floatOversamplers;
+    Oversamplers<double> doubleOversamplers;
+
+    template<typename SampleType>
+    Oversamplers<SampleType>& getOversamplers()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleOversamplers;
+        else
+            return floatOversamplers;
+    }
+
+    template<typename SampleType>
+    void prepareOversamplers(size_t numChannels, int samplesPerBlock);
+
+    std::atomic<float>* oversamplingParameter{ apvts.getRawParameterValue("Oversampling") };
+    std::atomic<float>* oversamplingFilterParameter{ apvts.getRawParameterValue("Oversampling Filter") };
+    std::atomic<float>* oversamplingOfflineOnlyParameter{ apvts.getRawParameterValue("Oversampling Offline Only") };
+
+    // Ordem pedida, já considerando a opção de sobreamostrar só em renderizações
+    int getRequestedOversamplingOrder() const;
+    int getRequestedOversamplingFilter() const { return static_cast<int>(oversamplingFilterParameter->load()); }
+
+    // Troca a sobreamostragem e reprojeta todos os filtros para a nova taxa (thread de áudio)
+    template<typename SampleType>
+    void setOversampling(int order, int filter);
+
+    // Cadeia IIR no motor em uso, na taxa em que os filtros foram projetados
+    template<typename SampleType>
+    void processFilterChain(const juce::dsp::AudioBlock<SampleType>& block);
+
+    // Usados apenas na thread de áudio
+    int activeOversamplingOrder{ 0 }, activeOversamplingFilter{ 0 };
+
+    // Latência de cada sobreamostrador, em amostras na taxa do host; escrita em prepareToPlay
+    std::array<std::array<int, numOversamplingFilters>, maxOversamplingOrder> oversamplingLatencies{};
+
+    std::atomic<double> filterSampleRate{ 44100.0 };
+
+    //==============================================================================
+    // Modo de espera. Com a entrada em silêncio a cadeia continua rodando até a
+    // cauda decair silenceThresholdDb; depois o estado é zerado, o processamento é
+    // pulado e a saída é silêncio até a entrada voltar.
+    static constexpr double silenceThresholdDb = -120.0;
+
+    template<typename SampleType>
+    static bool isSilent(const juce::AudioBuffer<SampleType>& buffer);
+
+    // Recalcula a cauda do modo em uso, em amostras na taxa do host
+    void updateTailLength();
+
+    template<typename SampleType>
+    void enterSleep();
+    void leaveSleep();
+
+    // Usados apenas na thread de áudio
+    bool sleeping{ false };
+    bool iirTailDirty{ true };
+    double iirTailSamples{ 0.0 };
+    juce::int64 silentSamples{ 0 }, tailSamples{ 0 };
+
+    // Lida por getTailLengthSeconds, em qualquer thread
+    std::atomic<double> tailLengthSeconds{ 0.0 };
+
+    //==============================================================================
+    // Modo de fase linear. A thread de áudio publica os alvos atuais em
+    // linearPhaseSettings; a thread de fundo lê, projeta o kernel e o entrega ao
+    // convolvedor, e a latência é informada ao host pela thread de mensagens.
+    PartitionedConvolver linearPhaseConvolver;
+    SeqLockSnapshot<ChainSettings> linearPhaseSettings;
+
+    std::atomic<float>* phaseModeParameter{ apvts.getRawParameterValue("Phase Mode") };
+    std::atomic<float>* linearPhaseLengthParameter{ apvts.getRawParameterValue("Linear Phase Length") };
+
+    bool isLinearPhaseEnabled() const { return phaseModeParameter->load() >= 0.5f; }
+    int getLinearPhaseLength() const { return minLinearPhaseLength << static_cast<int>(linearPhaseLengthParameter->load()); }
+
+    // Usado apenas na thread de áudio
+    bool linearPhaseActive{ false };
+
+    // Usados apenas na thread de fundo (ou em prepareToPlay, com ela parada)
+    double linearPhaseSampleRate{ 44100.0 };
+    uint32_t designedLinearPhaseVersion{ 0 };
+    int designedLinearPhaseLength{ 0 };
+    std::vector<float> linearPhaseImpulse;
+
+    std::atomic<int> reportedLatency{ 0 };
+
+    // Calcula a latência do modo pedido e, se mudou, pede que seja informada ao host
+    void updateLatency();
+
+    // Projeta um novo kernel se os alvos ou o comprimento mudaram e o anterior já foi adotado
+    void updateLinearPhaseKernel();
+
+    void handleAsyncUpdate() override;
+
+    struct BackgroundThread : juce::Thread
+    {
+        explicit BackgroundThread(EqualizadorAudioProcessor& p) : juce::Thread("Equalizador Background"), processor(p) {}
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                processor.updateLatency();
+                processor.updateLinearPhaseKernel();
+                wait(10);
+            }
+        }
+
+        EqualizadorAudioProcessor& processor;
+    };
+
+    BackgroundThread backgroundThread{ *this };
+
     juce::dsp::Oscillator<float> osc;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EqualizadorAudioProcessor)
@@ -0,0 +1,407 @@
+/*
+  ==============================================================================
+
+    Cascata de filtros de variáveis de estado com transformação trapezoidal
+    (TPT SVF, na formulação de Zavalishin/Simper).
+
+    Ao contrário da forma direta usada pelos biquads, o estado desta estrutura
+    continua bem comportado quando os coeficientes mudam a cada amostra. Por
+    isso os parâmetros são interpolados amostra a amostra entre dois pontos da
+    grade de recálculo, em vez de saltarem uma vez por bloco.
+
+    As respostas de magnitude são as mesmas dos projetos bilineares em
+    BiquadDesign.h: o peak é o "bell" de Simper e os cortes usam os mesmos
+    fatores de qualidade dos Butterworth de alta ordem. Projetos casados são
+    convertidos a partir dos coeficientes biquad por makeSvfCoefficients().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadDesign.h"
+#include "BiquadCascade.h"
+
+//==============================================================================
+struct SvfCutCoefficients
+{
+    std::array<SvfCoefficients, maxCutFilterSections> sections;
+    int numSections{ 0 };
+};
+
+struct SvfPeakBandCoefficients
+{
+    std::array<SvfCoefficients, maxPeakBands> bands;
+    std::array<bool, maxPeakBands> active{};
+    std::array<StereoPlacement, maxPeakBands> placement{};
+};
+
+// Coeficientes de toda a cadeia LowCut -> Peaks -> HighCut
+struct SvfChainCoefficients
+{
+    SvfCutCoefficients lowCut, highCut;
+    SvfPeakBandCoefficients peaks;
+
+    StereoPlacement lowCutPlacement{ Placement_Both }, highCutPlacement{ Placement_Both };
+
+    // Mesma estimativa de ChainCoefficients::getDecaySamples
+    double getDecaySamples(double attenuationDb) const
+    {
+        auto samples = 0.0;
+
+        for (int i = 0; i < maxPeakBands; ++i)
+            if (peaks.active[(size_t)i])
+                samples += peaks.bands[(size_t)i].getDecaySamples(attenuationDb);
+
+        for (int i = 0; i < lowCut.numSections; ++i)
+            samples += lowCut.sections[(size_t)i].getDecaySamples(attenuationDb);
+
+        for (int i = 0; i < highCut.numSections; ++i)
+            samples += highCut.sections[(size_t)i].getDecaySamples(attenuationDb);
+
+        return samples;
+    }
+};
+
+//==============================================================================
+// tan(pi * f / fs) pela aproximação de Padé de juce::dsp::FastMathApproximations.
+// O erro relativo fica abaixo de 1e-7 até 0.49 * fs, bem menor que o da
+// interpolação linear de g entre dois pontos da grade.
+inline double getSvfPrewarpedFrequency(double sampleRate, double frequency)
+{
+    jassert(sampleRate > 0.0);
+    jassert(frequency > 0.0 && frequency <= sampleRate * 0.5);
+
+    const auto x = juce::MathConstants<double>::pi * juce::jlimit(2.0, sampleRate * 0.49, frequency) / sampleRate;
+    return juce::dsp::FastMathApproximations::tan(x);
+}
+
+inline SvfCoefficients makeSvfPeakCoefficients(double sampleRate, double frequency, double quality, double gainFactor)
+{
+    jassert(quality > 0.0);
+
+    const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+    const auto k = 1.0 / (quality * A);
+
+    return { getSvfPrewarpedFrequency(sampleRate, frequency), k, 1.0, k * (A * A - 1.0), 0.0 };
+}
+
+inline SvfCoefficients makeSvfHighPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    jassert(quality > 0.0);
+
+    const auto k = 1.0 / quality;
+    return { getSvfPrewarpedFrequency(sampleRate, frequency), k, 1.0, -k, -1.0 };
+}
+
+inline SvfCoefficients makeSvfLowPassCoefficients(double sampleRate, double frequency, double quality)
+{
+    jassert(quality > 0.0);
+
+    return { getSvfPrewarpedFrequency(sampleRate, frequency), 1.0 / quality, 0.0, 0.0, 1.0 };
+}
+
+inline SvfCutCoefficients makeSvfCutCoefficients(const CutFilterCoefficients& biquads)
+{
+    SvfCutCoefficients cut;
+    cut.numSections = biquads.numSections;
+
+    for (int i = 0; i < cut.numSections; ++i)
+        cut.sections[(size_t)i] = makeSvfCoefficients(biquads.sections[(size_t)i]);
+
+    return cut;
+}
+
+inline SvfCutCoefficients makeSvfButterworthHighPass(double sampleRate, double frequency, int order)
+{
+    jassert(order > 0 && order % 2 == 0 && order / 2 <= maxCutFilterSections);
+
+    SvfCutCoefficients cut;
+    cut.numSections = order / 2;
+
+    for (int i = 0; i < cut.numSections; ++i)
+        cut.sections[(size_t)i] = makeSvfHighPassCoefficients(sampleRate, frequency, getButterworthSectionQuality(i, order));
+
+    return cut;
+}
+
+inline SvfCutCoefficients makeSvfButterworthLowPass(double sampleRate, double frequency, int order)
+{
+    jassert(order > 0 && order % 2 == 0 && order / 2 <= maxCutFilterSections);
+
+    SvfCutCoefficients cut;
+    cut.numSections = order / 2;
+
+    for (int i = 0; i < cut.numSections; ++i)
+        cut.sections[(size_t)i] = makeSvfLowPassCoefficients(sampleRate, frequency, getButterworthSectionQuality(i, order));
+
+    return cut;
+}
+
+//==============================================================================
+template<typename SampleType>
+class SvfCascade
+{
+public:
+    using ElementType = typename SampleLanes<SampleType>::ElementType;
+
+    // LowCut (até 8 seções), as bandas peak e HighCut (até 8 seções)
+    static constexpr int maxSections = 2 * maxCutFilterSections + maxPeakBands;
+
+    void reset() noexcept
+    {
+        for (auto& slot : slots)
+            slot.ic1 = slot.ic2 = SampleType();
+
+        for (int i = 0; i < numActive; ++i)
+            ic1[(size_t)i] = ic2[(size_t)i] = SampleType();
+    }
+
+    // Recebe os novos alvos e os alcança linearmente nas próximas rampLength amostras
+    // (com zero, imediatamente). Seções que acabaram de ser ligadas partem do estado
+    // zero com g e k já no alvo e a saída na identidade (m0 = 1): a rampa de m é um
+    // crossfade exato, x + w (y - x). Com rampLength zero elas começam no alvo.
+    // As que acabaram de ser desligadas fazem o caminho inverso: m vai à identidade
+    // com g e k parados e só então a seção deixa a lista (com zero, imediatamente).
+    // Não aloca memória; pode ser chamado na thread de áudio entre dois blocos.
+    void setCoefficients(const SvfChainCoefficients& chain, int rampLength) noexcept
+    {
+        saveActiveState();
+
+        int slot = 0;
+        auto setCut = [this, &slot](const SvfCutCoefficients& cut, StereoPlacement placement)
+            {
+                for (int i = 0; i < maxCutFilterSections; ++i, ++slot)
+                    setSlot(slot, cut.sections[(size_t)i], i < cut.numSections, placement);
+            };
+
+        setCut(chain.lowCut, chain.lowCutPlacement);
+
+        for (int i = 0; i < maxPeakBands; ++i, ++slot)
+            setSlot(slot, chain.peaks.bands[(size_t)i], chain.peaks.active[(size_t)i], chain.peaks.placement[(size_t)i]);
+
+        setCut(chain.highCut, chain.highCutPlacement);
+
+        jassert(slot == maxSections);
+        rebuildActiveSections(juce::jmax(0, rampLength));
+    }
+
+    void process(SampleType* samples, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+        // Parâmetros em rampa: a cada amostra avança g, k e m e refaz os coeficientes
+        // do integrador. Os parâmetros são os mesmos em todas as faixas SIMD que a
+        // seção afeta; nas outras ela fica na identidade (g = 0, m0 = 1).
+        for (; i < numSamples && rampRemaining > 0; ++i, --rampRemaining)
+        {
+            auto x = samples[i];
+
+            for (size_t s = 0; s < (size_t)numActive; ++s)
+            {
+                auto& p = ramps[s];
+                p.g += p.dg;
+                p.k += p.dk;
+                p.m0 += p.dm0;
+                p.m1 += p.dm1;
+                p.m2 += p.dm2;
+
+                const auto a1 = ElementType(1) / (ElementType(1) + p.g * (p.g + p.k));
+                const auto a2 = p.g * a1;
+                const auto a3 = p.g * a2;
+                const auto placement = placements[s];
+
+                x = tick(x, s, place(a1, 1.0, placement), place(a2, 0.0, placement), place(a3, 0.0, placement),
+                         place(p.m0, 1.0, placement), place(p.m1, 0.0, placement), place(p.m2, 0.0, placement));
+            }
+
+            samples[i] = x;
+        }
+
+        if (rampRemaining == 0 && !rampFinished)
+            finishRamp();
+
+        for (; i < numSamples; ++i)
+        {
+            auto x = samples[i];
+
+            for (size_t s = 0; s < (size_t)numActive; ++s)
+                x = tick(x, s, a1[s], a2[s], a3[s], m0[s], m1[s], m2[s]);
+
+            samples[i] = x;
+        }
+    }
+
+private:
+    static SampleType place(double value, double identity, StereoPlacement placement) noexcept
+    {
+        return SampleLanes<SampleType>::place(value, identity, placement);
+    }
+
+    SampleType tick(SampleType x, size_t s,
+                    SampleType c1, SampleType c2, SampleType c3,
+                    SampleType n0, SampleType n1, SampleType n2) noexcept
+    {
+        const auto v3 = x - ic2[s];
+        const auto v1 = c1 * ic1[s] + c2 * v3;
+        const auto v2 = ic2[s] + c2 * ic1[s] + c3 * v3;
+
+        ic1[s] = v1 + v1 - ic1[s];
+        ic2[s] = v2 + v2 - ic2[s];
+
+        return n0 * x + n1 * v1 + n2 * v2;
+    }
+
+    // Cada posição fixa da cadeia guarda o alvo, os parâmetros em que está
+    // e, enquanto desligada, o estado que tinha. 'leaving' marca uma seção
+    // desligada que ainda está saindo da lista.
+    struct Slot
+    {
+        SvfCoefficients target, current;
+        bool active{ false }, wasActive{ false }, leaving{ false };
+        StereoPlacement placement{ Placement_Both };
+        SampleType ic1{}, ic2{};
+    };
+
+    struct Ramp
+    {
+        ElementType g, k, m0, m1, m2;
+        ElementType dg, dk, dm0, dm1, dm2;
+    };
+
+    void setSlot(int index, const SvfCoefficients& coefficients, bool active, StereoPlacement placement = Placement_Both) noexcept
+    {
+        auto& slot = slots[(size_t)index];
+        slot.wasActive = slot.active;
+        slot.active = active;
+
+        if (active)
+        {
+            slot.target = coefficients;
+            slot.placement = placement;
+        }
+    }
+
+    void saveActiveState() noexcept
+    {
+        for (int i = 0; i < numActive; ++i)
+        {
+            auto& slot = slots[(size_t)activeSlots[(size_t)i]];
+            const auto& p = ramps[(size_t)i];
+            slot.current = { (double)p.g, (double)p.k, (double)p.m0, (double)p.m1, (double)p.m2 };
+            slot.ic1 = ic1[(size_t)i];
+            slot.ic2 = ic2[(size_t)i];
+        }
+    }
+
+    void rebuildActiveSections(int rampLength) noexcept
+    {
+        numActive = 0;
+
+        for (int index = 0; index < maxSections; ++index)
+        {
+            auto& slot = slots[(size_t)index];
+
+            if (!slot.active)
+            {
+                // Uma seção desligada agora (ou ainda saindo) fica na lista até a identidade
+                slot.leaving = rampLength > 0 && (slot.wasActive || slot.leaving);
+
+                if (!slot.leaving)
+                    continue;
+
+                slot.target = { slot.current.g, slot.current.k, 1.0, 0.0, 0.0 };
+            }
+            else if (!slot.wasActive && !slot.leaving && rampLength > 0)
+            {
+                slot.current = { slot.target.g, slot.target.k, 1.0, 0.0, 0.0 };
+                slot.ic1 = slot.ic2 = SampleType();
+            }
+            else if (rampLength == 0)
+            {
+                slot.current = slot.target;
+            }
+
+            if (slot.active)
+                slot.leaving = false;
+
+            const auto s = (size_t)numActive++;
+            activeSlots[s] = index;
+            placements[s] = slot.placement;
+
+            const auto& from = slot.current;
+            const auto& to = slot.target;
+            const auto steps = (double)juce::jmax(1, rampLength);
+            auto& p = ramps[s];
+
+            p.g = (ElementType)from.g;
+            p.k = (ElementType)from.k;
+            p.m0 = (ElementType)from.m0;
+            p.m1 = (ElementType)from.m1;
+            p.m2 = (ElementType)from.m2;
+            p.dg = (ElementType)((to.g - from.g) / steps);
+            p.dk = (ElementType)((to.k - from.k) / steps);
+            p.dm0 = (ElementType)((to.m0 - from.m0) / steps);
+            p.dm1 = (ElementType)((to.m1 - from.m1) / steps);
+            p.dm2 = (ElementType)((to.m2 - from.m2) / steps);
+
+            ic1[s] = slot.ic1;
+            ic2[s] = slot.ic2;
+        }
+
+        rampRemaining = rampLength;
+        rampFinished = false;
+    }
+
+    // Fim da rampa: fixa os parâmetros no alvo, pré-calcula os coeficientes e tira
+    // da lista as seções que acabaram de sair
+    void finishRamp() noexcept
+    {
+        auto anyLeaving = false;
+
+        for (int i = 0; i < numActive; ++i)
+        {
+            const auto s = (size_t)i;
+            const auto& slot = slots[(size_t)activeSlots[s]];
+            const auto& to = slot.target;
+            anyLeaving = anyLeaving || slot.leaving;
+            auto& p = ramps[s];
+
+            p = { (ElementType)to.g, (ElementType)to.k, (ElementType)to.m0, (ElementType)to.m1, (ElementType)to.m2, 0, 0, 0, 0, 0 };
+
+            const auto c1 = 1.0 / (1.0 + to.g * (to.g + to.k));
+            const auto placement = placements[s];
+            a1[s] = place(c1, 1.0, placement);
+            a2[s] = place(to.g * c1, 0.0, placement);
+            a3[s] = place(to.g * to.g * c1, 0.0, placement);
+            m0[s] = place(to.m0, 1.0, placement);
+            m1[s] = place(to.m1, 0.0, placement);
+            m2[s] = place(to.m2, 0.0, placement);
+        }
+
+        rampFinished = true;
+
+        if (anyLeaving)
+        {
+            saveActiveState();
+
+            for (auto& slot : slots)
+                slot.leaving = false;
+
+            rebuildActiveSections(0);
+            finishRamp();
+        }
+    }
+
+    std::array<Slot, maxSections> slots;
+
+    // Seções ativas, na ordem da cadeia
+    std::array<Ramp, maxSections> ramps{};
+    std::array<SampleType, maxSections> a1, a2, a3, m0, m1, m2, ic1, ic2;
+    std::array<int, maxSections> activeSlots{};
+    std::array<StereoPlacement, maxSections> placements{};
+    int numActive{ 0 };
+    int rampRemaining{ 0 };
+    bool rampFinished{ true };
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    Verificações dos motores de filtro.
+
+    Não faz parte do plugin: compile como um aplicativo de console JUCE, com os
+    módulos juce_core, juce_audio_basics e juce_dsp e a pasta Source no caminho
+    de includes. Imprime cada verificação que falhar e termina com código 1 se
+    alguma falhou.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BiquadCascade.h"
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    int numFailures = 0;
+
+    void check(bool condition, const char* description)
+    {
+        if (!condition)
+        {
+            std::printf("FALHOU: %s\n", description);
+            ++numFailures;
+        }
+    }
+
+    using Vec = juce::dsp::SIMDRegister<float>;
+    using Cascade = BiquadCascade<Vec>;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int fadeLength = 32;
+
+    ChainCoefficients makeChain(double gain, int numPeaks)
+    {
+        ChainCoefficients chain;
+        chain.lowCut = makeCutFilterHighPass(sampleRate, 40.0, 4, Family_Butterworth, Design_Bilinear);
+        chain.highCut = makeCutFilterLowPass(sampleRate, 16000.0, 4, Family_Butterworth, Design_Bilinear);
+
+        for (int band = 0; band < numPeaks; ++band)
+        {
+            chain.peaks.bands[(size_t)band] = makePeakCoefficients(sampleRate, 200.0 * (band + 1), 1.0, gain, Design_Bilinear);
+            chain.peaks.active[(size_t)band] = true;
+        }
+
+        return chain;
+    }
+
+    void process(Cascade& cascade, int numSamples)
+    {
+        std::vector<Vec> samples((size_t)numSamples, Vec::expand(0.25f));
+        cascade.process(samples.data(), samples.size());
+    }
+
+    //==============================================================================
+    // O crossfade só deve ser armado quando uma seção entra ou sai da cadeia
+    void testFadeArming()
+    {
+        Cascade cascade;
+        cascade.setCoefficients(makeChain(2.0, 2), fadeLength);
+        check(cascade.isFading(), "seções ligadas entram pelo crossfade");
+
+        process(cascade, fadeLength);
+        check(!cascade.isFading(), "o crossfade termina depois de fadeLength amostras");
+
+        // Mesmas seções, outros coeficientes: nada entra nem sai
+        cascade.setCoefficients(makeChain(3.0, 2), fadeLength);
+        check(!cascade.isFading(), "uma troca de coeficientes não arma o crossfade");
+
+        cascade.setCoefficients(makeChain(3.0, 3), fadeLength);
+        check(cascade.isFading(), "uma banda ligada arma o crossfade");
+
+        // No meio do crossfade a banda nova ainda não chegou ao peso alvo
+        process(cascade, fadeLength / 2);
+        cascade.setCoefficients(makeChain(2.0, 3), fadeLength);
+        check(cascade.isFading(), "uma troca de coeficientes no meio do crossfade o mantém");
+
+        process(cascade, fadeLength);
+        check(!cascade.isFading(), "o crossfade retomado termina");
+
+        cascade.setCoefficients(makeChain(2.0, 2), fadeLength);
+        check(cascade.isFading(), "uma banda desligada sai pelo crossfade");
+
+        process(cascade, fadeLength);
+        check(!cascade.isFading(), "a banda desligada deixa a cadeia no fim do crossfade");
+
+        cascade.setCoefficients(makeChain(2.0, 2), fadeLength);
+        check(!cascade.isFading(), "os mesmos coeficientes não armam o crossfade");
+    }
+}
+
+int main()
+{
+    testFadeArming();
+
+    if (numFailures == 0)
+        std::printf("Todas as verificações passaram\n");
+
+    return numFailures == 0 ? 0 : 1;
+}